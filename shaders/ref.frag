@@ -3,13 +3,22 @@
 in float v_gate;
 out vec4 FragColor;
 
+uniform int u_moment; // rsl::PRODUCT_TYPE: 0 reflectivity, 1 velocity, 2 spectral width
+
 void main() {
     if (v_gate <= -9999.0) {
         discard;
     }
 
     vec3 color;
-    if (v_gate < 0.0) {
+    if (u_moment == 1) {
+        // toward the radar green, away red
+        float t = clamp(abs(v_gate) / 30.0, 0.0, 1.0);
+        color = (v_gate < 0.0) ? mix(vec3(0.1, 0.3, 0.1), vec3(0.1, 1.0, 0.2), t)
+                               : mix(vec3(0.3, 0.1, 0.1), vec3(1.0, 0.1, 0.1), t);
+    } else if (u_moment == 2) {
+        color = mix(vec3(0.2, 0.2, 0.2), vec3(0.9, 0.9, 0.2), clamp(v_gate / 10.0, 0.0, 1.0));
+    } else if (v_gate < 0.0) {
         color = vec3(0.1, 0.3, 0.9); // blue
     } else if (v_gate < 30.0) {
         color = vec3(0.1, 0.8, 0.2); // green
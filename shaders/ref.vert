@@ -6,22 +6,26 @@ layout(location = 2) in int gate_idx;  // gate index along radial
 layout(location = 3) in int radial_idx;// radial index
 
 uniform samplerBuffer u_radial_meta;
+uniform int u_radial_base;             // first texel of this sweep in u_radial_meta
+uniform samplerBuffer u_beam_geom;     // per gate: ground range, beam height, ground length, slant range
+uniform isamplerBuffer u_radial_geom;  // per radial: first u_beam_geom texel of its table
 uniform vec2 u_view_scale;
 uniform vec2 u_view_offset;
 
 out float v_gate;
 
 void main() {
-    vec4 m = texelFetch(u_radial_meta, radial_idx);
+    vec4 m = texelFetch(u_radial_meta, u_radial_base + radial_idx);
     float azimuth_deg = m.x;
-    float range_bin1 = m.y;
-    float gate_size = m.z;
-
     float delta_az = m.w;
-    float range_center = range_bin1 + gate_size * (float(gate_idx) + 0.5);
+
+    // Earth-curvature placement from the precomputed beam table
+    int geom_base = texelFetch(u_radial_geom, u_radial_base + radial_idx).x;
+    vec4 g = texelFetch(u_beam_geom, geom_base + gate_idx);
+    float range_center = g.x;
     float az = radians(azimuth_deg);
 
-    float cell_height = gate_size;
+    float cell_height = g.z;
     float cell_width = range_center * delta_az;
 
     vec2 radial_center = vec2(cos(az), sin(az)) * range_center;
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+#include "cells.hpp"
+#include "polar_grid.hpp"
+#include "util/parallel.hpp"
+
+namespace analysis {
+
+static const float DEG_TO_RAD = 0.01745329252f;
+
+// Per-component running sums, merged across sectors
+struct CellAccum{
+    int count = 0;
+    double area = 0.0;
+    double sum_x = 0.0;
+    double sum_y = 0.0;
+    double sum_value = 0.0;
+    float max_value = -1e30f;
+};
+
+// Read-only find, safe while other threads only read
+static inline int32_t find_root(const std::vector<int32_t>& parent, int32_t a){
+    while(parent[a] != a) a = parent[a];
+    return a;
+}
+
+// Find with path halving; only call on indices no other thread touches
+static inline int32_t find_compress(std::vector<int32_t>& parent, int32_t a){
+    while(parent[a] != a){
+        parent[a] = parent[parent[a]];
+        a = parent[a];
+    }
+    return a;
+}
+
+// Links the larger root under the smaller so roots stay the lowest index
+static inline void unite(std::vector<int32_t>& parent, int32_t a, int32_t b){
+    a = find_compress(parent, a);
+    b = find_compress(parent, b);
+    if(a == b) return;
+    if(a < b) parent[b] = a;
+    else parent[a] = b;
+}
+
+/**
+ * Implementation
+ * Each sector unions only gates of its own radials, so sectors run in parallel
+ * on one shared parent array. The seams (including last radial -> first) are
+ * joined afterwards, then each sector accumulates statistics for the roots it
+ * sees and the partial sums are merged.
+ */
+std::vector<StormCell> identify_cells(const rsl::Scan& scan, const CellOptions& options){
+    std::vector<StormCell> cells;
+
+    const PolarGrid grid(scan);
+    const int n = grid.radials();
+    const int g = grid.gates();
+    if(n == 0 || g == 0) return cells;
+
+    int sectors = options.sectors > 0 ? options.sectors : static_cast<int>(util::worker_count(n));
+    sectors = std::max(1, std::min(sectors, n));
+    auto sector_begin = [&](int s) { return static_cast<int>(static_cast<int64_t>(n) * s / sectors); };
+
+    // -1 marks background gates
+    std::vector<int32_t> parent(static_cast<size_t>(n) * g, -1);
+    auto index = [g](int i, int j) { return static_cast<int32_t>(static_cast<int64_t>(i) * g + j); };
+    auto inside = [&](int i, int j) {
+        const float v = grid.value(i, j);
+        return v != rsl::SENTINEL && v >= options.threshold;
+    };
+
+    util::parallel_for(static_cast<size_t>(sectors), [&](size_t s){
+        const int r0 = sector_begin(static_cast<int>(s));
+        const int r1 = sector_begin(static_cast<int>(s) + 1);
+        for(int i = r0; i < r1; ++i){
+            for(int j = 0; j < g; ++j){
+                if(!inside(i, j)) continue;
+                const int32_t idx = index(i, j);
+                parent[idx] = idx;
+                if(j > 0 && parent[idx - 1] >= 0) unite(parent, idx, idx - 1);
+                if(i > r0 && parent[idx - g] >= 0) unite(parent, idx, idx - g);
+            }
+        }
+    });
+
+    if(n > 1){
+        for(int s = 0; s < sectors; ++s){
+            const int i = sector_begin(s);
+            const int prev = (i == 0) ? n - 1 : i - 1;
+            for(int j = 0; j < g; ++j){
+                const int32_t a = index(i, j), b = index(prev, j);
+                if(parent[a] >= 0 && parent[b] >= 0) unite(parent, a, b);
+            }
+        }
+    }
+
+    std::vector<std::unordered_map<int32_t, CellAccum>> partial(sectors);
+    util::parallel_for(static_cast<size_t>(sectors), [&](size_t s){
+        const int r0 = sector_begin(static_cast<int>(s));
+        const int r1 = sector_begin(static_cast<int>(s) + 1);
+        std::unordered_map<int32_t, CellAccum> &acc = partial[s];
+        for(int i = r0; i < r1; ++i){
+            const float az = grid.azimuth(i) * DEG_TO_RAD;
+            const float sin_az = std::sin(az), cos_az = std::cos(az);
+            for(int j = 0; j < g; ++j){
+                const int32_t idx = index(i, j);
+                if(parent[idx] < 0) continue;
+                CellAccum &c = acc[find_root(parent, idx)];
+                const float v = grid.value(i, j);
+                const float r = grid.ground_range(i, static_cast<float>(j));
+                const float a = grid.gate_area(i, j);
+                c.count++;
+                c.area += a;
+                c.sum_x += static_cast<double>(a) * r * sin_az;
+                c.sum_y += static_cast<double>(a) * r * cos_az;
+                c.sum_value += v;
+                c.max_value = std::max(c.max_value, v);
+            }
+        }
+    });
+
+    std::unordered_map<int32_t, CellAccum> merged = std::move(partial[0]);
+    for(int s = 1; s < sectors; ++s){
+        for(const auto &entry : partial[s]){
+            CellAccum &c = merged[entry.first];
+            c.count += entry.second.count;
+            c.area += entry.second.area;
+            c.sum_x += entry.second.sum_x;
+            c.sum_y += entry.second.sum_y;
+            c.sum_value += entry.second.sum_value;
+            c.max_value = std::max(c.max_value, entry.second.max_value);
+        }
+    }
+
+    for(const auto &entry : merged){
+        const CellAccum &c = entry.second;
+        if(c.count < options.min_gates || c.area <= 0.0) continue;
+        StormCell cell;
+        cell.id = -1;
+        cell.age = 0;
+        cell.x = static_cast<float>(c.sum_x / c.area);
+        cell.y = static_cast<float>(c.sum_y / c.area);
+        cell.area = static_cast<float>(c.area);
+        cell.max_value = c.max_value;
+        cell.mean_value = static_cast<float>(c.sum_value / c.count);
+        cell.gate_count = c.count;
+        cell.u = 0.0f;
+        cell.v = 0.0f;
+        cells.push_back(cell);
+    }
+
+    std::sort(cells.begin(), cells.end(), [](const StormCell &a, const StormCell &b) {
+        return a.area > b.area;
+    });
+    return cells;
+}
+
+CellTracker::CellTracker(const TrackerOptions& options)
+    : options_(options)
+{
+}
+
+void CellTracker::reset(){
+    previous_.clear();
+    has_previous_ = false;
+}
+
+/**
+ * Implementation
+ * Greedy nearest match between the previous cells' extrapolated positions and
+ * the new centroids, closest pairs first, within max_speed * dt.
+ */
+void CellTracker::update(std::vector<StormCell>& cells, double time_seconds){
+    const double dt = time_seconds - previous_time_;
+    std::vector<bool> matched(cells.size(), false);
+
+    if(has_previous_ && dt > 0.0){
+        const double max_dist = options_.max_speed * dt;
+        const double max_dist_sq = max_dist * max_dist;
+
+        struct Pair{ double dist_sq; size_t prev; size_t cur; };
+        std::vector<Pair> pairs;
+        for(size_t p = 0; p < previous_.size(); ++p){
+            const StormCell &prev = previous_[p];
+            const double px = prev.x + prev.u * dt;
+            const double py = prev.y + prev.v * dt;
+            for(size_t c = 0; c < cells.size(); ++c){
+                const double dx = cells[c].x - px, dy = cells[c].y - py;
+                const double d = dx * dx + dy * dy;
+                if(d <= max_dist_sq) pairs.push_back({d, p, c});
+            }
+        }
+        std::sort(pairs.begin(), pairs.end(), [](const Pair &a, const Pair &b) {
+            return a.dist_sq < b.dist_sq;
+        });
+
+        std::vector<bool> taken(previous_.size(), false);
+        for(const Pair &pr : pairs){
+            if(taken[pr.prev] || matched[pr.cur]) continue;
+            taken[pr.prev] = true;
+            matched[pr.cur] = true;
+
+            const StormCell &prev = previous_[pr.prev];
+            StormCell &cell = cells[pr.cur];
+            const float u = static_cast<float>((cell.x - prev.x) / dt);
+            const float v = static_cast<float>((cell.y - prev.y) / dt);
+            const float w = (prev.age > 0) ? options_.motion_smoothing : 0.0f;
+            cell.id = prev.id;
+            cell.age = prev.age + 1;
+            cell.u = w * prev.u + (1.0f - w) * u;
+            cell.v = w * prev.v + (1.0f - w) * v;
+        }
+    }
+
+    for(size_t c = 0; c < cells.size(); ++c){
+        if(matched[c]) continue;
+        cells[c].id = next_id_++;
+        cells[c].age = 0;
+        cells[c].u = 0.0f;
+        cells[c].v = 0.0f;
+    }
+
+    previous_ = cells;
+    previous_time_ = time_seconds;
+    has_previous_ = true;
+}
+
+};
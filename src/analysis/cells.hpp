@@ -0,0 +1,74 @@
+#ifndef CELLS_HPP
+#define CELLS_HPP
+
+#include <vector>
+
+#include "rsl/rsl_wrapper.hpp"
+
+namespace analysis{
+
+typedef struct {
+    float threshold = 35.0f; // gates at or above this (product units) belong to cells
+    int min_gates = 10;      // smaller components are dropped as noise
+    int sectors = 0;         // azimuth sectors labeled in parallel, 0 picks from core count
+} CellOptions;
+
+// One connected region of thresholded gates
+typedef struct {
+    int id;          // tracker-assigned, -1 until tracked
+    int age;         // consecutive frames this cell has been tracked
+    float x, y;      // area-weighted centroid, meters east/north of the radar
+    float area;      // square meters
+    float max_value; // peak gate value
+    float mean_value;
+    int gate_count;
+    float u, v;      // motion, m/s east/north; zero until matched
+} StormCell;
+
+/**
+ * @fn identify_cells
+ * Labels 4-connected regions of gates at or above the threshold directly in
+ * polar space (the last radial connects back to the first) and computes
+ * their statistics
+ * @param scan      sweep to analyse
+ * @param options   threshold, noise and parallelism settings
+ * @returns one StormCell per region, ordered by descending area
+ */
+std::vector<StormCell> identify_cells(const rsl::Scan& scan, const CellOptions& options = CellOptions());
+
+typedef struct {
+    float max_speed = 40.0f;        // m/s, bounds how far a cell may move between frames
+    float motion_smoothing = 0.5f;  // weight of the previous motion when blending in a new one
+} TrackerOptions;
+
+/**
+ * Frame-to-frame tracker. Only the previous frame's cells are kept; each update
+ * matches against them and then replaces them.
+ */
+class CellTracker{
+    public:
+        explicit CellTracker(const TrackerOptions& options = TrackerOptions());
+
+        /**
+         * @fn update
+         * Matches cells to the previous frame by motion-extrapolated position
+         * and fills in id, age and motion
+         * @param cells         cells of the new frame, updated in place
+         * @param time_seconds  volume time (any epoch, only differences are used)
+         */
+        void update(std::vector<StormCell>& cells, double time_seconds);
+
+        // Forget the previous frame (e.g. when switching sites)
+        void reset();
+
+    private:
+        TrackerOptions options_;
+        std::vector<StormCell> previous_;
+        double previous_time_ = 0.0;
+        bool has_previous_ = false;
+        int next_id_ = 0;
+};
+
+};
+
+#endif
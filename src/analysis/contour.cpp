@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "contour.hpp"
+#include "polar_grid.hpp"
+#include "util/parallel.hpp"
+
+namespace analysis {
+
+// Identifies a grid edge: ((radial * (gates + 2) + gate + 1) << 1) | along_azimuth
+typedef uint64_t EdgeKey;
+
+// Marching squares segment, oriented with the inside on its left in (radial, gate) index space
+struct Segment{
+    EdgeKey start;
+    EdgeKey end;
+    float x, y; // crossing point on the start edge
+};
+
+// Chain of segments that leaves its sector at both ends
+struct Polyline{
+    EdgeKey start;
+    EdgeKey end;
+    std::vector<float> points; // start points of each segment, x, y pairs
+};
+
+struct SectorResult{
+    std::vector<Polyline> open;
+    std::vector<std::vector<float>> closed;
+};
+
+static inline bool is_inside(float v, float threshold){
+    return v != rsl::SENTINEL && v >= threshold;
+}
+
+// Crossing position between two nodes; gate centers for valid pairs, midway otherwise
+static inline float crossing(float a, float b, float threshold){
+    if(a == rsl::SENTINEL || b == rsl::SENTINEL || a == b) return 0.5f;
+    return std::min(1.0f, std::max(0.0f, (threshold - a) / (b - a)));
+}
+
+/**
+ * Implementation
+ * Walks segment chains: chains entering from outside the set come first and
+ * stay open, whatever is left over is closed loops.
+ */
+static void chain_segments(const std::vector<Segment>& segs, SectorResult& out){
+    std::unordered_map<EdgeKey, size_t> by_start;
+    std::unordered_set<EdgeKey> ends;
+    by_start.reserve(segs.size());
+    ends.reserve(segs.size());
+    for(size_t s = 0; s < segs.size(); ++s){
+        by_start.emplace(segs[s].start, s);
+        ends.insert(segs[s].end);
+    }
+
+    std::vector<bool> used(segs.size(), false);
+    auto walk = [&](size_t s, std::vector<float>& points) -> EdgeKey {
+        for(;;){
+            used[s] = true;
+            points.push_back(segs[s].x);
+            points.push_back(segs[s].y);
+            auto it = by_start.find(segs[s].end);
+            if(it == by_start.end() || used[it->second]) return segs[s].end;
+            s = it->second;
+        }
+    };
+
+    for(size_t s = 0; s < segs.size(); ++s){
+        if(ends.count(segs[s].start)) continue;
+        Polyline line;
+        line.start = segs[s].start;
+        line.end = walk(s, line.points);
+        out.open.push_back(std::move(line));
+    }
+
+    for(size_t s = 0; s < segs.size(); ++s){
+        if(used[s]) continue;
+        std::vector<float> ring;
+        walk(s, ring);
+        out.closed.push_back(std::move(ring));
+    }
+}
+
+/**
+ * Implementation
+ * Marching squares over the cells between radials [r0, r1) and their clockwise
+ * neighbours. Gate rows -1 and gates() are padding that is always outside, so
+ * every outline closes. Cell corners are visited counter-clockwise in
+ * (radial, gate) index space:
+ *   p0 = (i, j), p1 = (i + 1, j), p2 = (i + 1, j + 1), p3 = (i, j + 1)
+ */
+static SectorResult contour_sector(const PolarGrid& grid, float threshold, int r0, int r1){
+    const int n = grid.radials();
+    const int g = grid.gates();
+    const uint64_t stride = static_cast<uint64_t>(g) + 2;
+
+    auto key_radial = [&](int i, int j) -> EdgeKey { return ((i * stride + (j + 1)) << 1); };
+    auto key_azimuth = [&](int i, int j) -> EdgeKey { return ((i * stride + (j + 1)) << 1) | 1; };
+
+    std::vector<uint8_t> row_a(g + 2), row_b(g + 2);
+    auto fill_row = [&](int i, std::vector<uint8_t>& row){
+        row[0] = row[g + 1] = 0;
+        for(int j = 0; j < g; ++j){
+            row[j + 1] = is_inside(grid.value(i, j), threshold);
+        }
+    };
+
+    std::vector<Segment> segs;
+    fill_row(r0, row_a);
+    for(int i = r0; i < r1; ++i){
+        const int in = (i + 1) % n;
+        fill_row(in, row_b);
+
+        for(int j = -1; j < g; ++j){
+            const uint8_t c[4] = {row_a[j + 1], row_b[j + 1], row_b[j + 2], row_a[j + 2]};
+            const int mask = c[0] | (c[1] << 1) | (c[2] << 2) | (c[3] << 3);
+            if(mask == 0 || mask == 15) continue;
+
+            // Edge k runs from corner k to corner k + 1
+            const EdgeKey keys[4] = {key_azimuth(i, j), key_radial(in, j), key_azimuth(i, j + 1), key_radial(i, j)};
+
+            auto edge_point = [&](int k, float& x, float& y){
+                switch(k){
+                    case 0: {
+                        const float t = crossing(grid.value(i, j), grid.value(in, j), threshold);
+                        grid.to_cartesian(i + t, static_cast<float>(j), x, y);
+                        break;
+                    }
+                    case 1: {
+                        const float t = crossing(grid.value(in, j), grid.value(in, j + 1), threshold);
+                        grid.to_cartesian(static_cast<float>(in), j + t, x, y);
+                        break;
+                    }
+                    case 2: {
+                        const float t = crossing(grid.value(i, j + 1), grid.value(in, j + 1), threshold);
+                        grid.to_cartesian(i + t, static_cast<float>(j + 1), x, y);
+                        break;
+                    }
+                    default: {
+                        const float t = crossing(grid.value(i, j), grid.value(i, j + 1), threshold);
+                        grid.to_cartesian(static_cast<float>(i), j + t, x, y);
+                        break;
+                    }
+                }
+            };
+
+            auto emit = [&](int exit_edge, int entry_edge){
+                Segment s;
+                s.start = keys[exit_edge];
+                s.end = keys[entry_edge];
+                edge_point(exit_edge, s.x, s.y);
+                segs.push_back(s);
+            };
+
+            if(mask == 5 || mask == 10){
+                // Saddle: decide by the mean of the valid corners whether the
+                // inside corners connect through the cell center
+                float sum = 0.0f;
+                int count = 0;
+                const float v[4] = {grid.value(i, j), grid.value(in, j), grid.value(in, j + 1), grid.value(i, j + 1)};
+                for(float f : v){
+                    if(f == rsl::SENTINEL) continue;
+                    sum += f;
+                    ++count;
+                }
+                const bool center_inside = count > 0 && sum / count >= threshold;
+                for(int k = 0; k < 4; ++k){
+                    if(!c[k]) continue;
+                    emit(k, center_inside ? (k + 1) % 4 : (k + 3) % 4);
+                }
+            } else {
+                int exit_edge = -1, entry_edge = -1;
+                for(int k = 0; k < 4; ++k){
+                    const uint8_t a = c[k], b = c[(k + 1) % 4];
+                    if(a && !b) exit_edge = k;
+                    if(!a && b) entry_edge = k;
+                }
+                emit(exit_edge, entry_edge);
+            }
+        }
+        row_a.swap(row_b);
+    }
+
+    SectorResult result;
+    chain_segments(segs, result);
+    return result;
+}
+
+/**
+ * Implementation
+ * Joins the open chains of all sectors across the seams. Each chain's end edge
+ * is the start edge of exactly one other chain, so every walk closes.
+ */
+static void stitch_sectors(std::vector<SectorResult>& sectors, std::vector<std::vector<float>>& rings){
+    std::vector<Polyline*> open;
+    for(SectorResult &s : sectors){
+        for(Polyline &p : s.open) open.push_back(&p);
+        for(std::vector<float> &r : s.closed) rings.push_back(std::move(r));
+    }
+
+    std::unordered_map<EdgeKey, size_t> by_start;
+    by_start.reserve(open.size());
+    for(size_t p = 0; p < open.size(); ++p){
+        by_start.emplace(open[p]->start, p);
+    }
+
+    std::vector<bool> used(open.size(), false);
+    for(size_t p = 0; p < open.size(); ++p){
+        if(used[p]) continue;
+        std::vector<float> ring;
+        size_t cur = p;
+        while(!used[cur]){
+            used[cur] = true;
+            ring.insert(ring.end(), open[cur]->points.begin(), open[cur]->points.end());
+            auto it = by_start.find(open[cur]->end);
+            if(it == by_start.end()) break;
+            cur = it->second;
+        }
+        rings.push_back(std::move(ring));
+    }
+}
+
+static float signed_area(const std::vector<float>& ring){
+    const size_t n = ring.size() / 2;
+    double a = 0.0;
+    for(size_t k = 0; k < n; ++k){
+        const size_t l = (k + 1) % n;
+        a += static_cast<double>(ring[2 * k]) * ring[2 * l + 1] - static_cast<double>(ring[2 * l]) * ring[2 * k + 1];
+    }
+    return static_cast<float>(0.5 * a);
+}
+
+static float segment_distance_sq(const float *p, const float *a, const float *b){
+    const float dx = b[0] - a[0], dy = b[1] - a[1];
+    const float len_sq = dx * dx + dy * dy;
+    float t = (len_sq > 0.0f) ? ((p[0] - a[0]) * dx + (p[1] - a[1]) * dy) / len_sq : 0.0f;
+    t = std::min(1.0f, std::max(0.0f, t));
+    const float ex = a[0] + t * dx - p[0], ey = a[1] + t * dy - p[1];
+    return ex * ex + ey * ey;
+}
+
+/**
+ * Implementation
+ * Douglas-Peucker on a closed ring: split at the vertex farthest from vertex 0
+ * and simplify both halves with an explicit stack.
+ */
+static std::vector<float> simplify_ring(const std::vector<float>& ring, float tolerance){
+    const size_t n = ring.size() / 2;
+    if(tolerance <= 0.0f || n <= 4) return ring;
+
+    size_t far = 0;
+    float far_d = -1.0f;
+    for(size_t k = 1; k < n; ++k){
+        const float dx = ring[2 * k] - ring[0], dy = ring[2 * k + 1] - ring[1];
+        const float d = dx * dx + dy * dy;
+        if(d > far_d){
+            far_d = d;
+            far = k;
+        }
+    }
+
+    // Index n stands for vertex 0 closing the ring
+    auto point = [&](size_t k) { return &ring[2 * (k % n)]; };
+    std::vector<bool> keep(n + 1, false);
+    keep[0] = keep[far] = keep[n] = true;
+
+    const float tol_sq = tolerance * tolerance;
+    std::vector<std::pair<size_t, size_t>> stack = {{0, far}, {far, n}};
+    while(!stack.empty()){
+        const auto span = stack.back();
+        stack.pop_back();
+        float best = tol_sq;
+        size_t best_k = 0;
+        for(size_t k = span.first + 1; k < span.second; ++k){
+            const float d = segment_distance_sq(point(k), point(span.first), point(span.second));
+            if(d > best){
+                best = d;
+                best_k = k;
+            }
+        }
+        if(best_k){
+            keep[best_k] = true;
+            stack.push_back({span.first, best_k});
+            stack.push_back({best_k, span.second});
+        }
+    }
+
+    std::vector<float> out;
+    for(size_t k = 0; k < n; ++k){
+        if(!keep[k]) continue;
+        out.push_back(ring[2 * k]);
+        out.push_back(ring[2 * k + 1]);
+    }
+    return out;
+}
+
+/**
+ * Implementation
+ * One job per (threshold, sector), then one stitch/simplify job per threshold.
+ * Index space and east/north share orientation, so outer rings come out CCW.
+ */
+ContourSet extract_contours(const rsl::Scan& scan, const std::vector<float>& thresholds,
+                            const ContourOptions& options){
+    ContourSet set;
+    set.ring_offsets.push_back(0);
+
+    const PolarGrid grid(scan);
+    const int n = grid.radials();
+    if(n == 0 || grid.gates() == 0 || thresholds.empty()) return set;
+
+    int sectors = options.sectors > 0 ? options.sectors : static_cast<int>(util::worker_count(n)) * 2;
+    sectors = std::max(1, std::min(sectors, n));
+
+    const size_t levels = thresholds.size();
+    std::vector<SectorResult> partial(levels * sectors);
+    util::parallel_for(partial.size(), [&](size_t job){
+        const size_t level = job / sectors;
+        const int s = static_cast<int>(job % sectors);
+        const int r0 = static_cast<int>(static_cast<int64_t>(n) * s / sectors);
+        const int r1 = static_cast<int>(static_cast<int64_t>(n) * (s + 1) / sectors);
+        partial[job] = contour_sector(grid, thresholds[level], r0, r1);
+    });
+
+    std::vector<std::vector<std::vector<float>>> rings(levels);
+    util::parallel_for(levels, [&](size_t level){
+        std::vector<SectorResult> sector_results(std::make_move_iterator(partial.begin() + level * sectors),
+                                                 std::make_move_iterator(partial.begin() + (level + 1) * sectors));
+        std::vector<std::vector<float>> raw;
+        stitch_sectors(sector_results, raw);
+
+        for(const std::vector<float> &ring : raw){
+            std::vector<float> simple = simplify_ring(ring, options.simplify_tolerance);
+            if(simple.size() < 6) continue;
+            if(std::fabs(signed_area(simple)) < options.min_area) continue;
+            rings[level].push_back(std::move(simple));
+        }
+    });
+
+    for(size_t level = 0; level < levels; ++level){
+        for(const std::vector<float> &ring : rings[level]){
+            set.vertices.insert(set.vertices.end(), ring.begin(), ring.end());
+            set.ring_offsets.push_back(static_cast<uint32_t>(set.vertices.size() / 2));
+            set.ring_levels.push_back(thresholds[level]);
+        }
+    }
+    return set;
+}
+
+};
@@ -0,0 +1,42 @@
+#ifndef CONTOUR_HPP
+#define CONTOUR_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "rsl/rsl_wrapper.hpp"
+
+namespace analysis{
+
+typedef struct {
+    float simplify_tolerance = 250.0f; // Douglas-Peucker tolerance in meters, 0 keeps every vertex
+    float min_area = 0.0f;             // rings enclosing less than this (m^2) are dropped
+    int sectors = 0;                   // azimuth sectors processed in parallel, 0 picks from core count
+} ContourOptions;
+
+/**
+ * Closed threshold outlines in compact form. Vertices are meters east (x) and
+ * north (y) of the radar. Outer rings run counter-clockwise, holes clockwise.
+ */
+typedef struct {
+    std::vector<float> vertices;         // x, y pairs
+    std::vector<uint32_t> ring_offsets;  // ring k spans vertices [ring_offsets[k], ring_offsets[k + 1]) (in vertices, not floats)
+    std::vector<float> ring_levels;      // threshold each ring belongs to
+} ContourSet;
+
+/**
+ * @fn extract_contours
+ * Runs marching squares on the radial x gate grid of a sweep for each threshold
+ * and returns the closed outlines of the areas at or above it. Sentinel gates
+ * count as below every threshold.
+ * @param scan          sweep to contour
+ * @param thresholds    levels in product units (e.g. 35, 50 dBZ)
+ * @param options       simplification and parallelism settings
+ * @returns ContourSet with the rings of all thresholds
+ */
+ContourSet extract_contours(const rsl::Scan& scan, const std::vector<float>& thresholds,
+                            const ContourOptions& options = ContourOptions());
+
+};
+
+#endif
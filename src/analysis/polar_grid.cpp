@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <cmath>
+
+#include "polar_grid.hpp"
+
+namespace analysis {
+
+static const float DEG_TO_RAD = 0.01745329252f;
+
+PolarGrid::PolarGrid(const rsl::Scan& scan){
+    order_.reserve(scan.radials.size());
+    for(const rsl::Radial &r : scan.radials){
+        order_.push_back(&r);
+        gates_ = std::max(gates_, static_cast<int>(r.gates.size()));
+    }
+    std::sort(order_.begin(), order_.end(), [](const rsl::Radial *a, const rsl::Radial *b) {
+        return a->azimuth < b->azimuth;
+    });
+
+    // Radials of a sweep almost always share range_bin1 and gate_size
+    geometry::BeamGeometryCache &cache = geometry::BeamGeometryCache::shared();
+    tables_.reserve(order_.size());
+    for(const rsl::Radial *r : order_){
+        if(gates_ == 0) break;
+        if(tables_.empty() || order_[tables_.size() - 1]->range_bin1 != r->range_bin1 ||
+           order_[tables_.size() - 1]->gate_size != r->gate_size){
+            tables_.push_back(cache.get(scan.elevation, r->range_bin1, r->gate_size, static_cast<size_t>(gates_)));
+        } else {
+            tables_.push_back(tables_.back());
+        }
+    }
+
+    steps_.resize(order_.size(), 0.0f);
+    for(size_t i = 0; i < order_.size(); ++i){
+        float d = order_[(i + 1) % order_.size()]->azimuth - order_[i]->azimuth;
+        if(i + 1 == order_.size()) d += 360.0f;
+        steps_[i] = d;
+    }
+}
+
+/**
+ * Implementation
+ * Linear in azimuth and in range between the two neighbouring radials.
+ */
+void PolarGrid::to_cartesian(float radial, float gate, float& x, float& y) const {
+    const int n = radials();
+    const float fl = std::floor(radial);
+    const float t = radial - fl;
+    int i0 = static_cast<int>(fl) % n;
+    if(i0 < 0) i0 += n;
+    const int i1 = (i0 + 1) % n;
+
+    const float r = ground_range(i0, gate) + t * (ground_range(i1, gate) - ground_range(i0, gate));
+    const float az = (azimuth(i0) + t * steps_[i0]) * DEG_TO_RAD;
+    x = r * std::sin(az);
+    y = r * std::cos(az);
+}
+
+/**
+ * Implementation
+ * Annulus sector on the ground: ground range at the gate center times the
+ * ground length of the gate and the azimuth step of the radial.
+ */
+float PolarGrid::gate_area(int radial, int gate) const {
+    const geometry::BeamTable &t = *tables_[radial];
+    return t.ground_range(gate) * t.ground_length(gate) * steps_[radial] * DEG_TO_RAD;
+}
+
+};
@@ -0,0 +1,70 @@
+#ifndef POLAR_GRID_HPP
+#define POLAR_GRID_HPP
+
+#include <vector>
+
+#include "geometry/beam_geometry.hpp"
+#include "rsl/rsl_wrapper.hpp"
+
+/**
+ * Namespace for analysis run directly on polar sweeps
+ */
+namespace analysis{
+
+/**
+ * Azimuth-ordered view of a Scan as a radial x gate grid. Holds pointers into
+ * the scan (no gate copies), so the scan must outlive the grid. Radials shorter
+ * than the longest one read as SENTINEL past their end. Positions come from
+ * the shared beam geometry tables (ground range, not slant range).
+ */
+class PolarGrid{
+    public:
+        PolarGrid() = delete;
+        explicit PolarGrid(const rsl::Scan& scan);
+
+        int radials() const { return static_cast<int>(order_.size()); }
+        int gates() const { return gates_; }
+
+        float value(int radial, int gate) const {
+            const std::vector<float> &g = order_[radial]->gates;
+            return (gate >= 0 && gate < static_cast<int>(g.size())) ? g[gate] : rsl::SENTINEL;
+        }
+
+        // Azimuth in degrees of a sorted radial
+        float azimuth(int radial) const { return order_[radial]->azimuth; }
+
+        // Clockwise azimuth step from radial to the next one (wrapping), degrees
+        float azimuth_step(int radial) const { return steps_[radial]; }
+
+        /**
+         * @fn ground_range
+         * Ground range in meters at a fractional gate index, measured to gate centers
+         * @param radial    sorted radial index
+         * @param gate      fractional gate index (-0.5 is the near edge of gate 0)
+         */
+        float ground_range(int radial, float gate) const {
+            return tables_[radial]->ground_range_at(gate);
+        }
+
+        /**
+         * @fn to_cartesian
+         * Position of a point given by a fractional radial and gate index, in
+         * meters east (x) and north (y) of the radar
+         * @param radial    fractional sorted radial index, wraps past the last radial
+         * @param gate      fractional gate index
+         */
+        void to_cartesian(float radial, float gate, float& x, float& y) const;
+
+        // Footprint of one gate in square meters
+        float gate_area(int radial, int gate) const;
+
+    private:
+        std::vector<const rsl::Radial*> order_;
+        std::vector<float> steps_;
+        std::vector<geometry::BeamGeometryCache::TablePtr> tables_;
+        int gates_ = 0;
+};
+
+};
+
+#endif
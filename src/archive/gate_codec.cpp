@@ -0,0 +1,24 @@
+#include "gate_codec.hpp"
+
+namespace archive {
+
+void encode_codes(const uint16_t* codes, size_t count, std::vector<uint8_t>& out){
+    int32_t prev = 0;
+    size_t j = 0;
+    while(j < count){
+        const int32_t delta = static_cast<int32_t>(codes[j]) - prev;
+        if(delta == 0){
+            size_t run = 1;
+            while(j + run < count && codes[j + run] == codes[j]) ++run;
+            put_varint(0, out);
+            put_varint(static_cast<uint32_t>(run - 1), out);
+            j += run;
+        } else {
+            put_varint((static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31), out);
+            prev = codes[j];
+            ++j;
+        }
+    }
+}
+
+};
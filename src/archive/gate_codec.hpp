@@ -0,0 +1,112 @@
+#ifndef GATE_CODEC_HPP
+#define GATE_CODEC_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "rsl/rsl_wrapper.hpp"
+
+/**
+ * Namespace for compact on-disk and in-memory sweep storage
+ */
+namespace archive{
+
+// Level II reflectivity, velocity and spectrum width all come in 0.5 unit steps
+const float QUANT_STEP = 0.5f;
+
+/**
+ * Linear gate quantizer: code = round((value - offset) / scale).
+ * Code 0 is reserved for rsl::SENTINEL.
+ */
+typedef struct {
+    float scale;
+    float offset;
+} Quantizer;
+
+/**
+ * @fn make_quantizer
+ * Quantizer whose code 1 sits at or just below the smallest value
+ * @param min_value smallest non-sentinel value that will be encoded
+ */
+inline Quantizer make_quantizer(float min_value){
+    Quantizer q;
+    q.scale = QUANT_STEP;
+    q.offset = (std::floor(min_value / QUANT_STEP) - 1.0f) * QUANT_STEP;
+    return q;
+}
+
+inline uint16_t quantize(const Quantizer& q, float value){
+    if(value == rsl::SENTINEL) return 0;
+    const float code = std::round((value - q.offset) / q.scale);
+    if(code < 1.0f) return 1;
+    if(code > 65535.0f) return 65535;
+    return static_cast<uint16_t>(code);
+}
+
+inline float dequantize(const Quantizer& q, uint16_t code){
+    return code ? q.offset + q.scale * static_cast<float>(code) : rsl::SENTINEL;
+}
+
+inline void put_varint(uint32_t v, std::vector<uint8_t>& out){
+    while(v >= 0x80){
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+// Reads one varint written by put_varint and advances data past it
+inline uint32_t read_varint(const uint8_t*& data, const uint8_t* end){
+    uint32_t v = 0;
+    for(int shift = 0; shift < 35; shift += 7){
+        if(data >= end) throw std::runtime_error("Truncated gate stream");
+        const uint8_t b = *data++;
+        v |= static_cast<uint32_t>(b & 0x7F) << shift;
+        if(!(b & 0x80)) return v;
+    }
+    throw std::runtime_error("Corrupt gate stream");
+}
+
+/**
+ * @fn encode_codes
+ * Appends one radial of codes to out as deltas along the radial (starting from
+ * 0) in zigzag varints. A zero token is followed by a varint run length, so
+ * flat stretches (mostly sentinel) collapse to two or three bytes.
+ * @param codes     quantized gates of the radial
+ * @param count     number of gates
+ * @param out       byte stream to append to
+ */
+void encode_codes(const uint16_t* codes, size_t count, std::vector<uint8_t>& out);
+
+/**
+ * @fn decode_codes
+ * Decodes count codes written by encode_codes and hands each to sink(gate, code)
+ * in gate order, so callers can write straight into their own buffers
+ * @param data      start of the encoded radial
+ * @param end       end of the readable bytes
+ * @returns pointer just past the radial
+ */
+template <typename Sink>
+const uint8_t* decode_codes(const uint8_t* data, const uint8_t* end, size_t count, Sink&& sink){
+    int32_t code = 0;
+    size_t gate = 0;
+    while(gate < count){
+        const uint32_t token = read_varint(data, end);
+        if(token == 0){
+            const size_t run = static_cast<size_t>(read_varint(data, end)) + 1;
+            if(run > count - gate) throw std::runtime_error("Corrupt gate stream");
+            for(size_t k = 0; k < run; ++k) sink(gate++, static_cast<uint16_t>(code));
+        } else {
+            code += static_cast<int32_t>(token >> 1) ^ -static_cast<int32_t>(token & 1);
+            sink(gate++, static_cast<uint16_t>(code));
+        }
+    }
+    return data;
+}
+
+};
+
+#endif
@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_set>
+
+#include "loop_store.hpp"
+#include "gate_codec.hpp"
+#include "util/parallel.hpp"
+
+namespace archive {
+
+// Unchanged stretches shorter than this stay inside the surrounding run; a
+// run header costs about as much as re-encoding a few gates
+static const size_t RUN_MERGE_GAP = 4;
+
+// Radials of one tilt in azimuth order, shared by every frame coded against it
+struct LoopStore::TiltKey{
+    Quantizer quantizer;
+    std::vector<float> azimuths;        // raw sorted azimuths, matched against later frames
+    std::vector<uint32_t> gate_counts;
+    size_t gate_total = 0;
+    std::vector<float> radial_meta;     // finished, see render::finish_sweep
+    float max_range = 0.0f;
+    std::vector<uint8_t> codes;         // encode_codes stream, one radial after another
+};
+
+struct LoopStore::TiltFrame{
+    std::shared_ptr<const TiltKey> key;
+    float elevation = 0.0f;
+    std::vector<uint8_t> runs;          // (varint skip, varint length - 1, encode_codes)*; empty = the keyframe
+};
+
+struct LoopStore::Frame{
+    double time = 0.0;
+    std::vector<TiltFrame> tilts;
+};
+
+static void sort_radials(const rsl::Scan& scan, std::vector<const rsl::Radial*>& order){
+    order.clear();
+    order.reserve(scan.radials.size());
+    for(const rsl::Radial &r : scan.radials) order.push_back(&r);
+    std::stable_sort(order.begin(), order.end(), [](const rsl::Radial *a, const rsl::Radial *b) {
+        return a->azimuth < b->azimuth;
+    });
+}
+
+static float min_value(const std::vector<const rsl::Radial*>& order){
+    float min_v = 0.0f;
+    bool any = false;
+    for(const rsl::Radial *r : order){
+        for(float v : r->gates){
+            if(v == rsl::SENTINEL) continue;
+            if(!any || v < min_v) min_v = v;
+            any = true;
+        }
+    }
+    return min_v;
+}
+
+std::shared_ptr<const LoopStore::TiltKey> LoopStore::make_key(const std::vector<const rsl::Radial*>& order){
+    auto key = std::make_shared<TiltKey>();
+    key->quantizer = make_quantizer(min_value(order));
+
+    render::SweepBuffers meta;
+    std::vector<uint16_t> codes;
+    for(const rsl::Radial *r : order){
+        key->azimuths.push_back(r->azimuth);
+        key->gate_counts.push_back(static_cast<uint32_t>(r->gates.size()));
+        key->gate_total += r->gates.size();
+        render::add_radial_meta(meta, r->azimuth, r->range_bin1, r->gate_size, r->gates.size());
+
+        codes.resize(r->gates.size());
+        for(size_t j = 0; j < codes.size(); ++j) codes[j] = quantize(key->quantizer, r->gates[j]);
+        encode_codes(codes.data(), codes.size(), key->codes);
+    }
+    render::finish_sweep(meta);
+    key->radial_meta = std::move(meta.radial_meta);
+    key->max_range = meta.max_range;
+    key->codes.shrink_to_fit();
+    return key;
+}
+
+// Same radial layout within half a beam per radial, and no values the key's quantizer would clamp
+bool LoopStore::matches_key(const TiltKey& key, const std::vector<const rsl::Radial*>& order){
+    if(order.size() != key.azimuths.size()) return false;
+    for(size_t i = 0; i < order.size(); ++i){
+        const rsl::Radial &r = *order[i];
+        const float *meta = &key.radial_meta[i * render::RADIAL_META_STRIDE];
+        if(r.gates.size() != key.gate_counts[i]) return false;
+        if(r.range_bin1 != meta[1] || r.gate_size != meta[2]) return false;
+        float d = std::fabs(r.azimuth - key.azimuths[i]);
+        d = std::min(d, 360.0f - d);
+        if(d > 0.5f * meta[3] * 57.2957795f) return false;
+    }
+    return min_value(order) >= dequantize(key.quantizer, 1);
+}
+
+/**
+ * Implementation
+ * Both the frame and its keyframe are expanded to flat code arrays in sorted
+ * radial order, then every stretch of differing codes becomes one run.
+ */
+LoopStore::TiltFrame LoopStore::encode_tilt(const rsl::Scan& scan, const std::shared_ptr<const TiltKey>& current){
+    TiltFrame frame;
+    frame.elevation = scan.elevation;
+
+    std::vector<const rsl::Radial*> order;
+    sort_radials(scan, order);
+    if(!current || !matches_key(*current, order)){
+        frame.key = make_key(order);
+        return frame;
+    }
+
+    const TiltKey &key = *current;
+    std::vector<uint16_t> codes(key.gate_total);
+    std::vector<uint16_t> key_codes(key.gate_total);
+    size_t pos = 0;
+    const uint8_t *data = key.codes.data();
+    const uint8_t *end = data + key.codes.size();
+    for(size_t i = 0; i < order.size(); ++i){
+        const std::vector<float> &gates = order[i]->gates;
+        for(size_t j = 0; j < gates.size(); ++j) codes[pos + j] = quantize(key.quantizer, gates[j]);
+        uint16_t *dst = key_codes.data() + pos;
+        data = decode_codes(data, end, gates.size(), [dst](size_t j, uint16_t code){ dst[j] = code; });
+        pos += gates.size();
+    }
+
+    const size_t n = key.gate_total;
+    size_t prev_end = 0;
+    size_t i = 0;
+    while(i < n){
+        if(codes[i] == key_codes[i]){
+            ++i;
+            continue;
+        }
+        size_t run_end = i + 1;
+        size_t same = 0;
+        for(size_t k = run_end; k < n; ++k){
+            if(codes[k] != key_codes[k]){
+                run_end = k + 1;
+                same = 0;
+            } else if(++same >= RUN_MERGE_GAP){
+                break;
+            }
+        }
+        put_varint(static_cast<uint32_t>(i - prev_end), frame.runs);
+        put_varint(static_cast<uint32_t>(run_end - i - 1), frame.runs);
+        encode_codes(codes.data() + i, run_end - i, frame.runs);
+        prev_end = run_end;
+        i = run_end;
+    }
+
+    // Once the scene has drifted this far a fresh keyframe is cheaper for every later frame too
+    if(frame.runs.size() > key.codes.size() / 2){
+        frame.runs = std::vector<uint8_t>();
+        frame.key = make_key(order);
+        return frame;
+    }
+    frame.key = current;
+    frame.runs.shrink_to_fit();
+    return frame;
+}
+
+LoopStore::LoopStore() = default;
+LoopStore::~LoopStore() = default;
+
+size_t LoopStore::add_frame(const rsl::Product& product, double time_seconds){
+    const size_t tilts = product.scans.size();
+    if(current_keys_.size() < tilts) current_keys_.resize(tilts);
+
+    Frame frame;
+    frame.time = time_seconds;
+    frame.tilts.resize(tilts);
+    util::parallel_for(tilts, [&](size_t t){
+        frame.tilts[t] = encode_tilt(product.scans[t], current_keys_[t]);
+    });
+    for(size_t t = 0; t < tilts; ++t) current_keys_[t] = frame.tilts[t].key;
+
+    frames_.push_back(std::move(frame));
+    return frames_.size() - 1;
+}
+
+void LoopStore::pop_front(){
+    if(!frames_.empty()) frames_.erase(frames_.begin());
+}
+
+size_t LoopStore::frame_count() const {
+    return frames_.size();
+}
+
+int LoopStore::tilt_count(size_t frame) const {
+    return static_cast<int>(frames_.at(frame).tilts.size());
+}
+
+double LoopStore::frame_time(size_t frame) const {
+    return frames_.at(frame).time;
+}
+
+float LoopStore::elevation(size_t frame, int tilt) const {
+    return frames_.at(frame).tilts.at(static_cast<size_t>(tilt)).elevation;
+}
+
+/**
+ * Implementation
+ * Gates are written once from the keyframe stream in place in out.gates, then
+ * only the values inside the frame's runs are overwritten.
+ */
+void LoopStore::decode(size_t frame, int tilt, render::SweepBuffers& out) const {
+    if(frame >= frames_.size()) throw std::out_of_range("Loop frame out of range");
+    const Frame &f = frames_[frame];
+    if(tilt < 0 || static_cast<size_t>(tilt) >= f.tilts.size()) throw std::out_of_range("Loop tilt out of range");
+    const TiltFrame &tf = f.tilts[tilt];
+    const TiltKey &key = *tf.key;
+    const Quantizer q = key.quantizer;
+
+    out.radial_meta.assign(key.radial_meta.begin(), key.radial_meta.end());
+    out.max_range = key.max_range;
+    out.gates.resize(key.gate_total);
+
+    render::GateInstance *dst = out.gates.data();
+    const uint8_t *data = key.codes.data();
+    const uint8_t *end = data + key.codes.size();
+    for(size_t r = 0; r < key.gate_counts.size(); ++r){
+        const int radial_idx = static_cast<int>(r);
+        data = decode_codes(data, end, key.gate_counts[r], [&](size_t j, uint16_t code){
+            dst[j].gate = dequantize(q, code);
+            dst[j].gate_idx = static_cast<int>(j);
+            dst[j].radial_idx = radial_idx;
+        });
+        dst += key.gate_counts[r];
+    }
+
+    data = tf.runs.data();
+    end = data + tf.runs.size();
+    size_t pos = 0;
+    while(data < end){
+        pos += read_varint(data, end);
+        const size_t length = static_cast<size_t>(read_varint(data, end)) + 1;
+        if(pos > key.gate_total || length > key.gate_total - pos) throw std::runtime_error("Corrupt loop frame");
+        render::GateInstance *run = out.gates.data() + pos;
+        data = decode_codes(data, end, length, [&](size_t j, uint16_t code){
+            run[j].gate = dequantize(q, code);
+        });
+        pos += length;
+    }
+}
+
+size_t LoopStore::memory_bytes() const {
+    size_t bytes = sizeof(LoopStore) + frames_.capacity() * sizeof(Frame);
+    std::unordered_set<const TiltKey*> keys;
+    auto add_key = [&](const TiltKey *key) {
+        if(!key || !keys.insert(key).second) return;
+        bytes += sizeof(TiltKey)
+            + key->azimuths.capacity() * sizeof(float)
+            + key->gate_counts.capacity() * sizeof(uint32_t)
+            + key->radial_meta.capacity() * sizeof(float)
+            + key->codes.capacity();
+    };
+    for(const Frame &f : frames_){
+        bytes += f.tilts.capacity() * sizeof(TiltFrame);
+        for(const TiltFrame &tf : f.tilts){
+            bytes += tf.runs.capacity();
+            add_key(tf.key.get());
+        }
+    }
+    for(const auto &key : current_keys_) add_key(key.get());
+    return bytes;
+}
+
+};
@@ -0,0 +1,79 @@
+#ifndef LOOP_STORE_HPP
+#define LOOP_STORE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "rsl/rsl_wrapper.hpp"
+#include "render/sweep_buffers.hpp"
+
+namespace archive{
+
+/**
+ * In-memory animation loop of one moment. Each tilt keeps a keyframe (radial
+ * geometry plus delta/run-length coded gate codes, see encode_codes) that
+ * later frames share, and each frame stores only the runs of gates whose
+ * quantized code differs from that keyframe. Frames decode independently of
+ * each other, straight into upload buffers.
+ *
+ * A frame tilt starts a new keyframe when its geometry no longer matches
+ * (radial count, range_bin1, gate_size, gate count, or any azimuth further than
+ * half a beam from the keyframe's), when it holds a value below the keyframe
+ * quantizer's range, or when its delta would be larger than half the keyframe.
+ */
+class LoopStore{
+    public:
+        LoopStore();
+        ~LoopStore();
+
+        LoopStore(const LoopStore&) = delete;
+        LoopStore& operator=(const LoopStore&) = delete;
+
+        /**
+         * @fn add_frame
+         * Encodes a volume as the newest frame (tilts in parallel)
+         * @param product       volume of the stored moment; tilt i is product.scans[i]
+         * @param time_seconds  volume time, kept for playback
+         * @returns index of the new frame
+         */
+        size_t add_frame(const rsl::Product& product, double time_seconds);
+
+        // Drops the oldest frame (sliding loop window); unused keyframes are freed
+        void pop_front();
+
+        size_t frame_count() const;
+        int tilt_count(size_t frame) const;
+        double frame_time(size_t frame) const;
+        float elevation(size_t frame, int tilt) const;
+
+        /**
+         * @fn decode
+         * Rebuilds one tilt of one frame into upload buffers: keyframe gates
+         * first, then the frame's changed runs patched over them
+         * @param frame     frame index, 0 is the oldest kept frame
+         * @param tilt      tilt index
+         * @param out       buffers to fill (capacity is reused)
+         * @throws std::out_of_range for a frame or tilt that is not stored
+         */
+        void decode(size_t frame, int tilt, render::SweepBuffers& out) const;
+
+        // Resident bytes of all frames and the keyframes they reference
+        size_t memory_bytes() const;
+
+    private:
+        struct TiltKey;
+        struct TiltFrame;
+        struct Frame;
+
+        static std::shared_ptr<const TiltKey> make_key(const std::vector<const rsl::Radial*>& order);
+        static bool matches_key(const TiltKey& key, const std::vector<const rsl::Radial*>& order);
+        static TiltFrame encode_tilt(const rsl::Scan& scan, const std::shared_ptr<const TiltKey>& current);
+
+        std::vector<Frame> frames_;
+        std::vector<std::shared_ptr<const TiltKey>> current_keys_;
+};
+
+};
+
+#endif
@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "sweep_archive.hpp"
+#include "gate_codec.hpp"
+
+namespace archive {
+
+static const char FILE_MAGIC[8] = {'O', 'R', 'S', 'W', 'E', 'E', 'P', '1'};
+static const char INDEX_MAGIC[8] = {'O', 'R', 'S', 'W', 'I', 'D', 'X', '1'};
+static const size_t CHUNK_HEADER_SIZE = 16;
+static const size_t RADIAL_HEADER_SIZE = 16;
+static const size_t INDEX_ENTRY_SIZE = 40;
+static const size_t TRAILER_SIZE = 20;
+// Far above any real radial (Level II tops out under 2000 gates)
+static const uint32_t MAX_RADIAL_GATES = 65535;
+
+// Little-endian field helpers, independent of host byte order
+static void put_u32(std::vector<uint8_t>& out, uint32_t v){
+    for(int k = 0; k < 4; ++k) out.push_back(static_cast<uint8_t>(v >> (8 * k)));
+}
+
+static void put_u64(std::vector<uint8_t>& out, uint64_t v){
+    for(int k = 0; k < 8; ++k) out.push_back(static_cast<uint8_t>(v >> (8 * k)));
+}
+
+static void put_f32(std::vector<uint8_t>& out, float f){
+    uint32_t v;
+    std::memcpy(&v, &f, sizeof(v));
+    put_u32(out, v);
+}
+
+static uint32_t get_u32(const uint8_t* p){
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static uint64_t get_u64(const uint8_t* p){
+    return static_cast<uint64_t>(get_u32(p)) | (static_cast<uint64_t>(get_u32(p + 4)) << 32);
+}
+
+static float get_f32(const uint8_t* p){
+    const uint32_t v = get_u32(p);
+    float f;
+    std::memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+SweepArchiveWriter::SweepArchiveWriter(const std::string& path)
+    : file_(path, std::ios::binary | std::ios::trunc), path_(path)
+{
+    if(!file_){
+        throw std::runtime_error("Could not create sweep archive: " + path);
+    }
+    file_.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    offset_ = sizeof(FILE_MAGIC);
+}
+
+SweepArchiveWriter::~SweepArchiveWriter(){
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+void SweepArchiveWriter::write_sweep(rsl::PRODUCT_TYPE moment, int sweep, const rsl::Scan& scan){
+    if(!file_.is_open()){
+        throw std::runtime_error("Sweep archive already closed: " + path_);
+    }
+
+    float min_value = 0.0f;
+    bool any = false;
+    uint64_t gate_count = 0;
+    for(const rsl::Radial &r : scan.radials){
+        if(r.gates.size() > MAX_RADIAL_GATES){
+            throw std::runtime_error("Radial too long for sweep archive: " + path_);
+        }
+        gate_count += r.gates.size();
+        for(float v : r.gates){
+            if(v == rsl::SENTINEL) continue;
+            if(!any || v < min_value) min_value = v;
+            any = true;
+        }
+    }
+    const Quantizer q = make_quantizer(min_value);
+
+    chunk_.clear();
+    put_u32(chunk_, static_cast<uint32_t>(scan.radials.size()));
+    put_f32(chunk_, scan.elevation);
+    put_f32(chunk_, q.scale);
+    put_f32(chunk_, q.offset);
+    for(const rsl::Radial &r : scan.radials){
+        put_f32(chunk_, r.azimuth);
+        put_f32(chunk_, r.range_bin1);
+        put_f32(chunk_, r.gate_size);
+        put_u32(chunk_, static_cast<uint32_t>(r.gates.size()));
+    }
+    for(const rsl::Radial &r : scan.radials){
+        codes_.resize(r.gates.size());
+        for(size_t j = 0; j < r.gates.size(); ++j){
+            codes_[j] = quantize(q, r.gates[j]);
+        }
+        encode_codes(codes_.data(), codes_.size(), chunk_);
+    }
+
+    file_.write(reinterpret_cast<const char*>(chunk_.data()), static_cast<std::streamsize>(chunk_.size()));
+    if(!file_){
+        throw std::runtime_error("Could not write sweep archive: " + path_);
+    }
+
+    ChunkInfo info;
+    info.moment = moment;
+    info.sweep = sweep;
+    info.elevation = scan.elevation;
+    info.radial_count = static_cast<uint32_t>(scan.radials.size());
+    info.gate_count = gate_count;
+    info.offset = offset_;
+    info.size = chunk_.size();
+    index_.push_back(info);
+    offset_ += chunk_.size();
+}
+
+void SweepArchiveWriter::write_product(rsl::PRODUCT_TYPE moment, const rsl::Product& product){
+    for(size_t i = 0; i < product.scans.size(); ++i){
+        write_sweep(moment, static_cast<int>(i), product.scans[i]);
+    }
+}
+
+void SweepArchiveWriter::close(){
+    if(!file_.is_open()) return;
+
+    std::vector<uint8_t> footer;
+    footer.reserve(index_.size() * INDEX_ENTRY_SIZE + TRAILER_SIZE);
+    for(const ChunkInfo &info : index_){
+        put_u32(footer, static_cast<uint32_t>(info.moment));
+        put_u32(footer, static_cast<uint32_t>(info.sweep));
+        put_u64(footer, info.offset);
+        put_u64(footer, info.size);
+        put_f32(footer, info.elevation);
+        put_u32(footer, info.radial_count);
+        put_u64(footer, info.gate_count);
+    }
+    put_u64(footer, offset_);
+    put_u32(footer, static_cast<uint32_t>(index_.size()));
+    footer.insert(footer.end(), INDEX_MAGIC, INDEX_MAGIC + sizeof(INDEX_MAGIC));
+
+    file_.write(reinterpret_cast<const char*>(footer.data()), static_cast<std::streamsize>(footer.size()));
+    const bool ok = static_cast<bool>(file_);
+    file_.close();
+    if(!ok){
+        throw std::runtime_error("Could not write sweep archive index: " + path_);
+    }
+}
+
+/**
+ * Implementation
+ * Only the magic, the trailer and the index are read here.
+ */
+SweepArchiveReader::SweepArchiveReader(const std::string& path)
+    : file_(path, std::ios::binary), path_(path)
+{
+    if(!file_){
+        throw std::runtime_error("Could not open sweep archive: " + path);
+    }
+
+    char magic[sizeof(FILE_MAGIC)];
+    file_.read(magic, sizeof(magic));
+    file_.seekg(0, std::ios::end);
+    const uint64_t file_size = static_cast<uint64_t>(file_.tellg());
+    if(!file_ || std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 ||
+       file_size < sizeof(FILE_MAGIC) + TRAILER_SIZE){
+        throw std::runtime_error("Not a sweep archive: " + path);
+    }
+
+    uint8_t trailer[TRAILER_SIZE];
+    file_.seekg(static_cast<std::streamoff>(file_size - TRAILER_SIZE));
+    file_.read(reinterpret_cast<char*>(trailer), TRAILER_SIZE);
+    const uint64_t index_offset = get_u64(trailer);
+    const uint32_t entry_count = get_u32(trailer + 8);
+    if(!file_ || std::memcmp(trailer + 12, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+       index_offset + static_cast<uint64_t>(entry_count) * INDEX_ENTRY_SIZE + TRAILER_SIZE != file_size){
+        throw std::runtime_error("Sweep archive has no valid index: " + path);
+    }
+
+    std::vector<uint8_t> raw(static_cast<size_t>(entry_count) * INDEX_ENTRY_SIZE);
+    file_.seekg(static_cast<std::streamoff>(index_offset));
+    file_.read(reinterpret_cast<char*>(raw.data()), static_cast<std::streamsize>(raw.size()));
+    if(!file_){
+        throw std::runtime_error("Could not read sweep archive index: " + path);
+    }
+
+    index_.reserve(entry_count);
+    for(uint32_t e = 0; e < entry_count; ++e){
+        const uint8_t *p = raw.data() + static_cast<size_t>(e) * INDEX_ENTRY_SIZE;
+        const uint32_t moment = get_u32(p);
+        if(moment > static_cast<uint32_t>(rsl::SPECTRAL_WIDTH)){
+            throw std::runtime_error("Sweep archive index has unknown moment: " + path);
+        }
+        ChunkInfo info;
+        info.moment = static_cast<rsl::PRODUCT_TYPE>(moment);
+        info.sweep = static_cast<int>(get_u32(p + 4));
+        info.offset = get_u64(p + 8);
+        info.size = get_u64(p + 16);
+        info.elevation = get_f32(p + 24);
+        info.radial_count = get_u32(p + 28);
+        info.gate_count = get_u64(p + 32);
+        if(info.offset + info.size > index_offset){
+            throw std::runtime_error("Sweep archive index out of range: " + path);
+        }
+        index_.push_back(info);
+    }
+}
+
+const ChunkInfo* SweepArchiveReader::find(rsl::PRODUCT_TYPE moment, int sweep) const {
+    for(const ChunkInfo &info : index_){
+        if(info.moment == moment && info.sweep == sweep) return &info;
+    }
+    return nullptr;
+}
+
+const ChunkInfo& SweepArchiveReader::load_chunk(rsl::PRODUCT_TYPE moment, int sweep){
+    const ChunkInfo *info = find(moment, sweep);
+    if(!info){
+        throw std::runtime_error("Sweep not in archive: " + path_);
+    }
+
+    chunk_.resize(static_cast<size_t>(info->size));
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(info->offset));
+    file_.read(reinterpret_cast<char*>(chunk_.data()), static_cast<std::streamsize>(chunk_.size()));
+    if(!file_ || chunk_.size() < CHUNK_HEADER_SIZE + static_cast<size_t>(info->radial_count) * RADIAL_HEADER_SIZE){
+        throw std::runtime_error("Could not read sweep archive chunk: " + path_);
+    }
+    // The radial headers were only bounds-checked against the index count, and
+    // readers size their gate buffers from the index gate count
+    if(get_u32(chunk_.data()) != info->radial_count){
+        throw std::runtime_error("Corrupt sweep archive chunk: " + path_);
+    }
+    uint64_t total = 0;
+    const uint8_t *radial_header = chunk_.data() + CHUNK_HEADER_SIZE;
+    for(uint32_t i = 0; i < info->radial_count; ++i, radial_header += RADIAL_HEADER_SIZE){
+        const uint32_t gate_count = get_u32(radial_header + 12);
+        if(gate_count > MAX_RADIAL_GATES){
+            throw std::runtime_error("Corrupt sweep archive chunk: " + path_);
+        }
+        total += gate_count;
+    }
+    if(total != info->gate_count){
+        throw std::runtime_error("Corrupt sweep archive chunk: " + path_);
+    }
+    return *info;
+}
+
+/**
+ * Implementation
+ * Gates are decoded directly into their final GateInstance slots.
+ */
+void SweepArchiveReader::read_sweep(rsl::PRODUCT_TYPE moment, int sweep, render::SweepBuffers& out){
+    const ChunkInfo &info = load_chunk(moment, sweep);
+    const uint8_t *p = chunk_.data();
+    const uint8_t *end = p + chunk_.size();
+    const uint32_t radial_count = get_u32(p);
+    Quantizer q;
+    q.scale = get_f32(p + 8);
+    q.offset = get_f32(p + 12);
+
+    render::clear_sweep(out);
+    out.radial_meta.reserve(static_cast<size_t>(radial_count) * render::RADIAL_META_STRIDE);
+    out.gates.resize(static_cast<size_t>(info.gate_count));
+
+    const uint8_t *radial_header = p + CHUNK_HEADER_SIZE;
+    const uint8_t *payload = radial_header + static_cast<size_t>(radial_count) * RADIAL_HEADER_SIZE;
+    size_t base = 0;
+    for(uint32_t i = 0; i < radial_count; ++i, radial_header += RADIAL_HEADER_SIZE){
+        const uint32_t gate_count = get_u32(radial_header + 12);
+        if(base + gate_count > out.gates.size()){
+            throw std::runtime_error("Corrupt sweep archive chunk: " + path_);
+        }
+        render::add_radial_meta(out, get_f32(radial_header), get_f32(radial_header + 4),
+                                get_f32(radial_header + 8), gate_count);
+
+        render::GateInstance *dst = out.gates.data() + base;
+        const int radial_idx = static_cast<int>(i);
+        payload = decode_codes(payload, end, gate_count, [&](size_t j, uint16_t code){
+            dst[j].gate = dequantize(q, code);
+            dst[j].gate_idx = static_cast<int>(j);
+            dst[j].radial_idx = radial_idx;
+        });
+        base += gate_count;
+    }
+    out.gates.resize(base);
+
+    render::finish_sweep(out);
+}
+
+rsl::Scan SweepArchiveReader::read_scan(rsl::PRODUCT_TYPE moment, int sweep){
+    const ChunkInfo &info = load_chunk(moment, sweep);
+    const uint8_t *p = chunk_.data();
+    const uint8_t *end = p + chunk_.size();
+    const uint32_t radial_count = get_u32(p);
+    Quantizer q;
+    q.scale = get_f32(p + 8);
+    q.offset = get_f32(p + 12);
+
+    rsl::Scan scan;
+    scan.elevation = get_f32(p + 4);
+    scan.radials.resize(radial_count);
+
+    const uint8_t *radial_header = p + CHUNK_HEADER_SIZE;
+    const uint8_t *payload = radial_header + static_cast<size_t>(radial_count) * RADIAL_HEADER_SIZE;
+    uint64_t total = 0;
+    for(uint32_t i = 0; i < radial_count; ++i, radial_header += RADIAL_HEADER_SIZE){
+        const uint32_t gate_count = get_u32(radial_header + 12);
+        total += gate_count;
+        if(total > info.gate_count){
+            throw std::runtime_error("Corrupt sweep archive chunk: " + path_);
+        }
+        rsl::Radial &r = scan.radials[i];
+        r.azimuth = get_f32(radial_header);
+        r.range_bin1 = get_f32(radial_header + 4);
+        r.gate_size = get_f32(radial_header + 8);
+        r.gates.resize(gate_count);
+        payload = decode_codes(payload, end, r.gates.size(), [&](size_t j, uint16_t code){
+            r.gates[j] = dequantize(q, code);
+        });
+    }
+    return scan;
+}
+
+};
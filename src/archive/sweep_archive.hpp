@@ -0,0 +1,111 @@
+#ifndef SWEEP_ARCHIVE_HPP
+#define SWEEP_ARCHIVE_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "rsl/rsl_wrapper.hpp"
+#include "render/sweep_buffers.hpp"
+
+namespace archive{
+
+/**
+ * Chunked sweep archive layout (all integers and floats little-endian):
+ *   "ORSWEEP1"
+ *   chunk per (moment, sweep):
+ *     u32 radial_count, f32 elevation, f32 scale, f32 offset
+ *     radial_count x { f32 azimuth, f32 range_bin1, f32 gate_size, u32 gate_count }
+ *     encoded gates of every radial (see encode_codes)
+ *   index: entry_count x { u32 moment, u32 sweep, u64 offset, u64 size,
+ *                          f32 elevation, u32 radial_count, u64 gate_count }
+ *   u64 index_offset, u32 entry_count, "ORSWIDX1"
+ */
+
+// Index entry for one (moment, sweep) chunk
+typedef struct {
+    rsl::PRODUCT_TYPE moment;
+    int sweep;
+    float elevation;
+    uint32_t radial_count;
+    uint64_t gate_count;
+    uint64_t offset; // byte offset of the chunk in the file
+    uint64_t size;   // chunk size in bytes
+} ChunkInfo;
+
+class SweepArchiveWriter{
+    public:
+        SweepArchiveWriter() = delete;
+        explicit SweepArchiveWriter(const std::string& path);
+        // Writes the index if close() was not called; errors are swallowed
+        ~SweepArchiveWriter();
+
+        SweepArchiveWriter(const SweepArchiveWriter&) = delete;
+        SweepArchiveWriter& operator=(const SweepArchiveWriter&) = delete;
+
+        /**
+         * @fn write_sweep
+         * Quantizes and encodes one sweep as its own chunk
+         * @param moment    product the sweep belongs to
+         * @param sweep     sweep index within the product
+         * @param scan      sweep data
+         */
+        void write_sweep(rsl::PRODUCT_TYPE moment, int sweep, const rsl::Scan& scan);
+
+        // Writes every sweep of a product, indexed by position in product.scans
+        void write_product(rsl::PRODUCT_TYPE moment, const rsl::Product& product);
+
+        // Writes the index footer and closes the file; further writes throw
+        void close();
+
+    private:
+        std::ofstream file_;
+        std::string path_;
+        std::vector<ChunkInfo> index_;
+        std::vector<uint8_t> chunk_;
+        std::vector<uint16_t> codes_;
+        uint64_t offset_ = 0;
+};
+
+class SweepArchiveReader{
+    public:
+        SweepArchiveReader() = delete;
+        // Opens the archive and loads its index; no chunk data is read
+        explicit SweepArchiveReader(const std::string& path);
+
+        SweepArchiveReader(const SweepArchiveReader&) = delete;
+        SweepArchiveReader& operator=(const SweepArchiveReader&) = delete;
+
+        const std::vector<ChunkInfo>& index() const { return index_; }
+
+        // Index entry for (moment, sweep), or nullptr if it is not archived
+        const ChunkInfo* find(rsl::PRODUCT_TYPE moment, int sweep) const;
+
+        /**
+         * @fn read_sweep
+         * Reads a single chunk and decodes it straight into upload buffers
+         * @param moment    product to read
+         * @param sweep     sweep index within the product
+         * @param out       buffers to fill (capacity is reused)
+         */
+        void read_sweep(rsl::PRODUCT_TYPE moment, int sweep, render::SweepBuffers& out);
+
+        /**
+         * @fn read_scan
+         * Reads a single chunk back into wrapper form for the analysis code
+         */
+        rsl::Scan read_scan(rsl::PRODUCT_TYPE moment, int sweep);
+
+    private:
+        const ChunkInfo& load_chunk(rsl::PRODUCT_TYPE moment, int sweep);
+
+        std::ifstream file_;
+        std::string path_;
+        std::vector<ChunkInfo> index_;
+        std::vector<uint8_t> chunk_;
+};
+
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <cmath>
+
+#include "beam_geometry.hpp"
+// C API
+extern "C" {
+    #include "rsl.h"
+}
+
+namespace geometry {
+
+/**
+ * Implementation
+ * RSL works in km; tables are in meters like the rest of the wrapper.
+ */
+static float ground_range_m(float slant_m, float elevation){
+    float gr = 0.0f, h = 0.0f;
+    RSL_get_groundr_and_h(std::max(slant_m, 0.0f) / 1000.0f, elevation, &gr, &h);
+    return gr * 1000.0f;
+}
+
+BeamTable::BeamTable(float elevation, float range_bin1, float gate_size, size_t gate_count){
+    texels_.resize(gate_count * GEOMETRY_STRIDE);
+    for(size_t j = 0; j < gate_count; ++j){
+        const float slant = range_bin1 + gate_size * (static_cast<float>(j) + 0.5f);
+        float gr = 0.0f, h = 0.0f;
+        RSL_get_groundr_and_h(slant / 1000.0f, elevation, &gr, &h);
+
+        float *t = &texels_[j * GEOMETRY_STRIDE];
+        t[0] = gr * 1000.0f;
+        t[1] = h * 1000.0f;
+        t[2] = ground_range_m(slant + 0.5f * gate_size, elevation) - ground_range_m(slant - 0.5f * gate_size, elevation);
+        t[3] = slant;
+    }
+}
+
+float BeamTable::ground_range_at(float gate) const {
+    const size_t n = gate_count();
+    if(n == 0) return 0.0f;
+    if(n == 1) return ground_range(0) + gate * ground_length(0);
+
+    const float fl = std::floor(gate);
+    const size_t j = static_cast<size_t>(std::min(std::max(fl, 0.0f), static_cast<float>(n - 2)));
+    const float t = gate - static_cast<float>(j);
+    return ground_range(j) + t * (ground_range(j + 1) - ground_range(j));
+}
+
+/**
+ * Implementation
+ * Ground range grows monotonically with gate index, so binary search the
+ * gate centers and pick the neighbour whose footprint holds the range.
+ */
+int BeamTable::gate_at(double ground_range) const {
+    const size_t n = gate_count();
+    if(n == 0) return -1;
+
+    size_t lo = 0, hi = n;
+    while(lo < hi){
+        const size_t mid = (lo + hi) / 2;
+        if(texels_[mid * GEOMETRY_STRIDE] < ground_range) lo = mid + 1;
+        else hi = mid;
+    }
+
+    // lo is the first center at or beyond the range; the gate boundary sits half a length back
+    if(lo < n && ground_range >= this->ground_range(lo) - 0.5 * ground_length(lo)) return static_cast<int>(lo);
+    if(lo > 0 && ground_range < this->ground_range(lo - 1) + 0.5 * ground_length(lo - 1)) return static_cast<int>(lo - 1);
+    return -1;
+}
+
+BeamGeometryCache& BeamGeometryCache::shared(){
+    static BeamGeometryCache cache;
+    return cache;
+}
+
+BeamGeometryCache::TablePtr BeamGeometryCache::get(float elevation, float range_bin1, float gate_size, size_t gate_count){
+    // Sweep elevations jitter by a few thousandths of a degree between volumes
+    const Key key(static_cast<int32_t>(std::lround(elevation * 100.0f)),
+                  static_cast<int32_t>(std::lround(range_bin1)),
+                  static_cast<int32_t>(std::lround(gate_size)));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tables_.find(key);
+    if(it != tables_.end()){
+        TablePtr table = it->second.lock();
+        if(table && table->gate_count() >= gate_count) return table;
+    }
+
+    // Only adding can leave dead entries behind, so prune here
+    for(auto e = tables_.begin(); e != tables_.end();){
+        if(e->second.expired()) e = tables_.erase(e);
+        else ++e;
+    }
+
+    const float elev_key = static_cast<float>(std::get<0>(key)) / 100.0f;
+    TablePtr table = std::make_shared<const BeamTable>(elev_key, static_cast<float>(std::get<1>(key)),
+                                                       static_cast<float>(std::get<2>(key)), gate_count);
+    tables_[key] = table;
+    return table;
+}
+
+size_t BeamGeometryCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t alive = 0;
+    for(const auto &entry : tables_){
+        if(!entry.second.expired()) ++alive;
+    }
+    return alive;
+}
+
+};
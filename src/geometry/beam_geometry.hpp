@@ -0,0 +1,96 @@
+#ifndef BEAM_GEOMETRY_HPP
+#define BEAM_GEOMETRY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+/**
+ * Namespace for beam propagation geometry
+ */
+namespace geometry{
+
+/**
+ * Texels per gate in a beam table (one RGBA32F texel):
+ *   ground range to the gate center (m), beam height at the gate center (m),
+ *   ground length of the gate (m), slant range to the gate center (m)
+ */
+const size_t GEOMETRY_STRIDE = 4;
+
+/**
+ * Ground range and beam height per gate index for one (elevation, range_bin1,
+ * gate_size), from RSL's 4/3-earth model (RSL_get_groundr_and_h). Immutable
+ * once built, so any thread may read it.
+ */
+class BeamTable{
+    public:
+        BeamTable(float elevation, float range_bin1, float gate_size, size_t gate_count);
+
+        size_t gate_count() const { return texels_.size() / GEOMETRY_STRIDE; }
+        const std::vector<float>& texels() const { return texels_; }
+
+        float ground_range(size_t gate) const { return texels_[gate * GEOMETRY_STRIDE]; }
+        float height(size_t gate) const { return texels_[gate * GEOMETRY_STRIDE + 1]; }
+        float ground_length(size_t gate) const { return texels_[gate * GEOMETRY_STRIDE + 2]; }
+
+        /**
+         * @fn ground_range_at
+         * Ground range at a fractional gate index (gate centers at integers),
+         * linear between centers and extrapolated past either end
+         */
+        float ground_range_at(float gate) const;
+
+        /**
+         * @fn gate_at
+         * Gate whose ground footprint contains a ground range
+         * @param ground_range  meters from the radar along the ground
+         * @returns gate index, or -1 if outside the table
+         */
+        int gate_at(double ground_range) const;
+
+    private:
+        std::vector<float> texels_;
+};
+
+/**
+ * Process-wide cache of beam tables keyed by (elevation, range_bin1, gate_size).
+ * Consecutive volumes of a VCP reuse the same handful of tables, so they are
+ * built once while anything still holds them. The cache only keeps weak
+ * references: a table nobody uses any more (e.g. an averaged elevation of an
+ * old volume) is freed. Lookups are thread-safe.
+ */
+class BeamGeometryCache{
+    public:
+        typedef std::shared_ptr<const BeamTable> TablePtr;
+
+        // Shared instance used by the renderer and the CPU gridding code
+        static BeamGeometryCache& shared();
+
+        /**
+         * @fn get
+         * Table for a beam with at least gate_count gates, built on first use.
+         * A longer request than the cached table gets a new, longer table.
+         * @param elevation     elevation angle in degrees
+         * @param range_bin1    range to the first gate in meters
+         * @param gate_size     gate spacing in meters
+         * @param gate_count    gates needed
+         */
+        TablePtr get(float elevation, float range_bin1, float gate_size, size_t gate_count);
+
+        // Number of tables still alive
+        size_t size() const;
+
+    private:
+        typedef std::tuple<int32_t, int32_t, int32_t> Key;
+
+        mutable std::mutex mutex_;
+        std::map<Key, std::weak_ptr<const BeamTable>> tables_;
+};
+
+};
+
+#endif
@@ -9,7 +9,8 @@ class Buffer {
         enum class Target : uint32_t {
             Array = 0x8892,        // GL_ARRAY_BUFFER
             ElementArray = 0x8893, // GL_ELEMENT_ARRAY_BUFFER
-            Uniform = 0x8A11       // GL_UNIFORM_BUFFER
+            Uniform = 0x8A11,      // GL_UNIFORM_BUFFER
+            Texture = 0x8C2A       // GL_TEXTURE_BUFFER
         };
 
         enum class Usage : uint32_t {
@@ -135,6 +135,12 @@ void Shader::set_float(std::string_view name, float v) const {
     glUniform1f((GLint)loc, v);
 }
 
+void Shader::set_vec2(std::string_view name, float x, float y) const {
+    const int loc = uniform_location(name);
+    if (loc < 0) return;
+    glUniform2f((GLint)loc, x, y);
+}
+
 void Shader::set_mat4(std::string_view name, const float* mat4) const {
     const int loc = uniform_location(name);
     if (loc < 0) return;
@@ -25,6 +25,7 @@ class Shader{
         // might need more/less depending on what we use
         void set_int(std::string_view name, int v) const;
         void set_float(std::string_view name, float v) const;
+        void set_vec2(std::string_view name, float x, float y) const;
         void set_mat4(std::string_view name, const float* mat4) const;
 
         uint32_t id() const { return program_; }
@@ -0,0 +1,59 @@
+#include <utility>
+
+#include <glad/glad.h>
+
+#include "texture_buffer.hpp"
+
+TextureBuffer::~TextureBuffer() {
+    destroy();
+}
+
+TextureBuffer::TextureBuffer(TextureBuffer&& other) noexcept
+    : buffer_(std::move(other.buffer_)) {
+    tex_ = other.tex_;
+    format_ = other.format_;
+    other.tex_ = 0;
+}
+
+TextureBuffer& TextureBuffer::operator=(TextureBuffer&& other) noexcept {
+    if (this != &other) {
+        destroy();
+        buffer_ = std::move(other.buffer_);
+        tex_ = other.tex_;
+        format_ = other.format_;
+        other.tex_ = 0;
+    }
+    return *this;
+}
+
+void TextureBuffer::create(Format format) {
+    if (tex_) {
+        destroy();
+    }
+    format_ = format;
+    buffer_.create(Buffer::Target::Texture);
+    glGenTextures(1, reinterpret_cast<GLuint*>(&tex_));
+}
+
+void TextureBuffer::destroy() {
+    if (tex_) {
+        glDeleteTextures(1, reinterpret_cast<const GLuint*>(&tex_));
+        tex_ = 0;
+    }
+    buffer_.destroy();
+}
+
+void TextureBuffer::set_data(const void* data, size_t size, Buffer::Usage usage) {
+    buffer_.set_data(data, size, usage);
+    glBindTexture(GL_TEXTURE_BUFFER, static_cast<GLuint>(tex_));
+    glTexBuffer(GL_TEXTURE_BUFFER, static_cast<GLenum>(format_), static_cast<GLuint>(buffer_.id()));
+}
+
+void TextureBuffer::update_data(const void* data, size_t size, size_t offset) {
+    buffer_.update_data(data, size, offset);
+}
+
+void TextureBuffer::bind(uint32_t unit) const {
+    glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(unit));
+    glBindTexture(GL_TEXTURE_BUFFER, static_cast<GLuint>(tex_));
+}
@@ -0,0 +1,46 @@
+#ifndef TEXTURE_BUFFER_HPP
+#define TEXTURE_BUFFER_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include "buffer.hpp"
+
+// Buffer texture (samplerBuffer) together with the buffer that backs it
+class TextureBuffer {
+    public:
+        enum class Format : uint32_t {
+            R32F = 0x822E,    // GL_R32F
+            RG32F = 0x8230,   // GL_RG32F
+            RGBA32F = 0x8814, // GL_RGBA32F
+            R32I = 0x8235     // GL_R32I
+        };
+
+        TextureBuffer() = default;
+        ~TextureBuffer();
+
+        TextureBuffer(const TextureBuffer&) = delete;
+        TextureBuffer& operator=(const TextureBuffer&) = delete;
+        TextureBuffer(TextureBuffer&&) noexcept;
+        TextureBuffer& operator=(TextureBuffer&&) noexcept;
+
+        void create(Format format);
+        void destroy();
+
+        // (Re)allocates the backing buffer and attaches it to the texture
+        void set_data(const void* data, size_t size, Buffer::Usage usage);
+        void update_data(const void* data, size_t size, size_t offset = 0);
+
+        // Binds the texture to GL_TEXTURE0 + unit
+        void bind(uint32_t unit) const;
+
+        uint32_t id() const { return tex_; }
+        explicit operator bool() const { return tex_ != 0; }
+
+    private:
+        Buffer buffer_;
+        uint32_t tex_ = 0;
+        Format format_ = Format::RGBA32F;
+};
+
+#endif
@@ -0,0 +1,298 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+#include <stdexcept>
+
+#include "mosaic.hpp"
+#include "geometry/beam_geometry.hpp"
+#include "util/parallel.hpp"
+
+namespace mosaic {
+
+static const double EARTH_RADIUS_M = 6371000.0;
+static const double DEG_TO_RAD = 0.017453292519943295;
+static const double METERS_PER_DEG = EARTH_RADIUS_M * DEG_TO_RAD;
+
+/**
+ * Implementation
+ * Everything needed to sample one site: its location, the lowest tilt of the
+ * requested product and the radials sorted by azimuth for nearest-beam lookup.
+ * Immutable once built so tiles can read it from any thread.
+ */
+struct Mosaic::SiteVolume{
+    std::string id;
+    rsl::SiteLocation loc;
+    double sin_lat;
+    double cos_lat;
+    rsl::Scan scan;
+    std::vector<float> azimuths; // ascending
+    std::vector<int> order;      // scan.radials index of each sorted azimuth
+    std::vector<geometry::BeamGeometryCache::TablePtr> tables; // beam table of each sorted azimuth
+    float max_range;             // ground range, meters
+};
+
+Mosaic::Mosaic(const GridSpec& grid, rsl::PRODUCT_TYPE product_type, OVERLAP_RULE rule)
+    : grid_(grid), product_type_(product_type), rule_(rule)
+{
+    if(grid_.cell_deg <= 0.0 || grid_.tile_size <= 0 ||
+       grid_.lat_max <= grid_.lat_min || grid_.lon_max <= grid_.lon_min){
+        throw std::runtime_error("Invalid mosaic grid");
+    }
+
+    width_ = static_cast<int>(std::ceil((grid_.lon_max - grid_.lon_min) / grid_.cell_deg));
+    height_ = static_cast<int>(std::ceil((grid_.lat_max - grid_.lat_min) / grid_.cell_deg));
+    tiles_x_ = (width_ + grid_.tile_size - 1) / grid_.tile_size;
+    tiles_y_ = (height_ + grid_.tile_size - 1) / grid_.tile_size;
+    values_.assign(static_cast<size_t>(width_) * height_, rsl::SENTINEL);
+}
+
+Mosaic::~Mosaic() = default;
+
+/**
+ * Implementation
+ * Decode (serialized inside RadarData), product extraction and azimuth sort.
+ */
+Mosaic::SitePtr Mosaic::build_site(const SiteSource& source) const {
+    auto site = std::make_shared<SiteVolume>();
+    site->id = source.site_id;
+    site->loc = rsl::get_site_location(source.site_id);
+    site->sin_lat = std::sin(site->loc.latitude * DEG_TO_RAD);
+    site->cos_lat = std::cos(site->loc.latitude * DEG_TO_RAD);
+
+    rsl::RadarData radar_data(source.file_path, source.site_id);
+    rsl::Product product = radar_data.get_product(product_type_);
+
+    // Mosaic the lowest tilt
+    const rsl::Scan *lowest = nullptr;
+    for(const rsl::Scan &s : product.scans){
+        if(s.radials.empty()) continue;
+        if(!lowest || s.elevation < lowest->elevation) lowest = &s;
+    }
+    if(!lowest){
+        throw std::runtime_error("No sweeps in volume: " + source.file_path);
+    }
+    site->scan = *lowest;
+
+    const std::vector<rsl::Radial> &radials = site->scan.radials;
+    site->order.resize(radials.size());
+    std::iota(site->order.begin(), site->order.end(), 0);
+    std::sort(site->order.begin(), site->order.end(), [&](int a, int b) {
+        return radials[a].azimuth < radials[b].azimuth;
+    });
+
+    size_t max_gates = 0;
+    for(const rsl::Radial &r : radials) max_gates = std::max(max_gates, r.gates.size());
+
+    geometry::BeamGeometryCache &cache = geometry::BeamGeometryCache::shared();
+    site->azimuths.reserve(radials.size());
+    site->tables.reserve(radials.size());
+    site->max_range = 0.0f;
+    for(int idx : site->order){
+        const rsl::Radial &r = radials[idx];
+        site->azimuths.push_back(r.azimuth);
+        if(r.gates.empty()){
+            site->tables.push_back(nullptr);
+            continue;
+        }
+        site->tables.push_back(cache.get(site->scan.elevation, r.range_bin1, r.gate_size, max_gates));
+        const geometry::BeamTable &t = *site->tables.back();
+        const size_t last = r.gates.size() - 1;
+        site->max_range = std::max(site->max_range, t.ground_range(last) + 0.5f * t.ground_length(last));
+    }
+
+    return site;
+}
+
+/**
+ * Implementation
+ * Marks the tiles touched by the site's max range bounding box. The east-west
+ * half-width of a range circle of angular radius c is asin(sin c / cos lat0),
+ * wider than c / cos lat0 at high latitude; it covers every longitude once the
+ * circle reaches a pole.
+ */
+void Mosaic::mark_coverage(const SiteVolume& site, std::vector<bool>& tiles) const {
+    const double c = site.max_range / EARTH_RADIUS_M;
+    const double dlat = c / DEG_TO_RAD;
+    const double sin_c = std::sin(std::min(c, 90.0 * DEG_TO_RAD));
+    const double dlon = (sin_c >= site.cos_lat) ? 180.0 : std::asin(sin_c / site.cos_lat) / DEG_TO_RAD;
+
+    const int col0 = static_cast<int>(std::floor((site.loc.longitude - dlon - grid_.lon_min) / grid_.cell_deg));
+    const int col1 = static_cast<int>(std::floor((site.loc.longitude + dlon - grid_.lon_min) / grid_.cell_deg));
+    const int row0 = static_cast<int>(std::floor((grid_.lat_max - (site.loc.latitude + dlat)) / grid_.cell_deg));
+    const int row1 = static_cast<int>(std::floor((grid_.lat_max - (site.loc.latitude - dlat)) / grid_.cell_deg));
+    if(col1 < 0 || row1 < 0 || col0 >= width_ || row0 >= height_) return;
+
+    const int tx0 = std::max(col0, 0) / grid_.tile_size;
+    const int tx1 = std::min(col1, width_ - 1) / grid_.tile_size;
+    const int ty0 = std::max(row0, 0) / grid_.tile_size;
+    const int ty1 = std::min(row1, height_ - 1) / grid_.tile_size;
+    for(int ty = ty0; ty <= ty1; ++ty){
+        for(int tx = tx0; tx <= tx1; ++tx){
+            tiles[static_cast<size_t>(ty) * tiles_x_ + tx] = true;
+        }
+    }
+}
+
+size_t Mosaic::load_sites(const std::vector<SiteSource>& sources){
+    std::vector<SitePtr> loaded(sources.size());
+    util::parallel_for(sources.size(), [&](size_t i){
+        try {
+            loaded[i] = build_site(sources[i]);
+        } catch (const std::exception &e) {
+            std::fprintf(stderr, "Mosaic: skipping %s: %s\n", sources[i].site_id.c_str(), e.what());
+        }
+    });
+
+    std::vector<bool> tiles(static_cast<size_t>(tiles_x_) * tiles_y_, false);
+    size_t count = 0;
+    for(SitePtr &site : loaded){
+        if(!site) continue;
+        auto it = sites_.find(site->id);
+        if(it != sites_.end()){
+            mark_coverage(*it->second, tiles);
+        }
+        mark_coverage(*site, tiles);
+        sites_[site->id] = std::move(site);
+        ++count;
+    }
+
+    compose(tiles);
+    return count;
+}
+
+void Mosaic::update_site(const SiteSource& source){
+    SitePtr site = build_site(source);
+
+    std::vector<bool> tiles(static_cast<size_t>(tiles_x_) * tiles_y_, false);
+    auto it = sites_.find(site->id);
+    if(it != sites_.end()){
+        mark_coverage(*it->second, tiles);
+    }
+    mark_coverage(*site, tiles);
+    sites_[site->id] = std::move(site);
+
+    compose(tiles);
+}
+
+void Mosaic::remove_site(const std::string& site_id){
+    auto it = sites_.find(site_id);
+    if(it == sites_.end()) return;
+
+    std::vector<bool> tiles(static_cast<size_t>(tiles_x_) * tiles_y_, false);
+    mark_coverage(*it->second, tiles);
+    sites_.erase(it);
+
+    compose(tiles);
+}
+
+/**
+ * Implementation
+ * Works out which sites can reach each marked tile, then fills the tiles in
+ * parallel. Tiles own disjoint cell ranges so no locking is needed.
+ */
+void Mosaic::compose(const std::vector<bool>& tiles){
+    dirty_tiles_.clear();
+    for(size_t t = 0; t < tiles.size(); ++t){
+        if(tiles[t]) dirty_tiles_.push_back(t);
+    }
+
+    std::vector<std::vector<const SiteVolume*>> tile_sites(tiles.size());
+    for(const auto &entry : sites_){
+        std::vector<bool> covered(tiles.size(), false);
+        mark_coverage(*entry.second, covered);
+        for(size_t t : dirty_tiles_){
+            if(covered[t]) tile_sites[t].push_back(entry.second.get());
+        }
+    }
+
+    util::parallel_for(dirty_tiles_.size(), [&](size_t i){
+        const size_t t = dirty_tiles_[i];
+        compose_tile(t, tile_sites[t]);
+    });
+}
+
+/**
+ * Implementation
+ * Value of the beam nearest to (bearing, range), or false if the point falls
+ * outside the sweep or on a sentinel gate.
+ */
+static bool sample_site_at(const rsl::Scan &scan, const std::vector<float> &azimuths,
+                           const std::vector<int> &order,
+                           const std::vector<geometry::BeamGeometryCache::TablePtr> &tables,
+                           double bearing_deg, double range_m, float &value_out){
+    if(azimuths.empty()) return false;
+
+    // Nearest radial by azimuth, wrapping at north
+    const size_t n = azimuths.size();
+    const float az = static_cast<float>(bearing_deg);
+    size_t hi = static_cast<size_t>(std::lower_bound(azimuths.begin(), azimuths.end(), az) - azimuths.begin());
+    const size_t lo = (hi == 0) ? n - 1 : hi - 1;
+    if(hi == n) hi = 0;
+    float d_hi = std::fabs(azimuths[hi] - az);
+    float d_lo = std::fabs(az - azimuths[lo]);
+    d_hi = std::min(d_hi, 360.0f - d_hi);
+    d_lo = std::min(d_lo, 360.0f - d_lo);
+    const size_t nearest = (d_hi < d_lo) ? hi : lo;
+    const rsl::Radial &radial = scan.radials[order[nearest]];
+    if(!tables[nearest]) return false;
+
+    // Ground range to gate through the earth-curvature table
+    const int gate = tables[nearest]->gate_at(range_m);
+    if(gate < 0 || gate >= static_cast<int>(radial.gates.size())) return false;
+
+    const float v = radial.gates[static_cast<size_t>(gate)];
+    if(v == rsl::SENTINEL) return false;
+    value_out = v;
+    return true;
+}
+
+void Mosaic::compose_tile(size_t tile, const std::vector<const SiteVolume*>& sites){
+    const int tx = static_cast<int>(tile % tiles_x_);
+    const int ty = static_cast<int>(tile / tiles_x_);
+    const int col0 = tx * grid_.tile_size;
+    const int row0 = ty * grid_.tile_size;
+    const int col1 = std::min(col0 + grid_.tile_size, width_);
+    const int row1 = std::min(row0 + grid_.tile_size, height_);
+
+    for(int row = row0; row < row1; ++row){
+        const double lat = (grid_.lat_max - (row + 0.5) * grid_.cell_deg) * DEG_TO_RAD;
+        const double sin_lat = std::sin(lat);
+        const double cos_lat = std::cos(lat);
+        float *out = values_.data() + static_cast<size_t>(row) * width_;
+
+        for(int col = col0; col < col1; ++col){
+            const double lon = grid_.lon_min + (col + 0.5) * grid_.cell_deg;
+            float best = rsl::SENTINEL;
+            double best_range = 0.0;
+
+            for(const SiteVolume *site : sites){
+                // Great-circle distance and bearing from the site to the cell center
+                const double dlon = (lon - site->loc.longitude) * DEG_TO_RAD;
+                const double cos_dlon = std::cos(dlon);
+                double cos_c = site->sin_lat * sin_lat + site->cos_lat * cos_lat * cos_dlon;
+                cos_c = std::max(-1.0, std::min(1.0, cos_c));
+                const double range = EARTH_RADIUS_M * std::acos(cos_c);
+                if(range > site->max_range) continue;
+
+                double bearing = std::atan2(std::sin(dlon) * cos_lat,
+                                            site->cos_lat * sin_lat - site->sin_lat * cos_lat * cos_dlon) / DEG_TO_RAD;
+                if(bearing < 0.0) bearing += 360.0;
+
+                float v;
+                if(!sample_site_at(site->scan, site->azimuths, site->order, site->tables, bearing, range, v)) continue;
+
+                const bool take = (best == rsl::SENTINEL) ||
+                                  (rule_ == MAXIMUM ? v > best : range < best_range);
+                if(take){
+                    best = v;
+                    best_range = range;
+                }
+            }
+
+            out[col] = best;
+        }
+    }
+}
+
+};
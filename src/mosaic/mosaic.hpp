@@ -0,0 +1,105 @@
+#ifndef MOSAIC_HPP
+#define MOSAIC_HPP
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rsl/rsl_wrapper.hpp"
+
+/**
+ * Namespace for multi-radar mosaicking onto a shared lat/lon grid
+ */
+namespace mosaic{
+
+// How a grid cell covered by more than one site picks its value
+enum OVERLAP_RULE{
+    NEAREST_BEAM, // valid sample from the closest site (lowest beam) wins
+    MAXIMUM       // largest valid sample wins
+};
+
+// Regular lat/lon grid, split into square tiles of tile_size cells
+typedef struct {
+    double lat_min;
+    double lat_max;
+    double lon_min;
+    double lon_max;
+    double cell_deg;  // grid spacing in degrees (same for lat and lon)
+    int tile_size;    // cells per tile edge
+} GridSpec;
+
+// One Level II volume to place on the grid
+typedef struct {
+    std::string site_id;   // 4-letter WSR-88D id, used for the location lookup
+    std::string file_path; // Level II archive
+} SiteSource;
+
+class Mosaic{
+    public:
+        // RAII - no default constructor
+        Mosaic() = delete;
+        Mosaic(const GridSpec& grid, rsl::PRODUCT_TYPE product_type, OVERLAP_RULE rule);
+        ~Mosaic();
+
+        /**
+         * @fn load_sites
+         * Loads every source concurrently and recomposes all tiles they cover.
+         * Sites that fail to load are reported on stderr and skipped.
+         * @param sources   volumes to add (replacing earlier volumes of the same site)
+         * @returns number of sites loaded
+         */
+        size_t load_sites(const std::vector<SiteSource>& sources);
+
+        /**
+         * @fn update_site
+         * Replaces one site's volume and recomposes only the tiles covered by
+         * its previous or new coverage
+         * @param source    new volume for the site
+         */
+        void update_site(const SiteSource& source);
+
+        /**
+         * @fn remove_site
+         * Drops a site and recomposes the tiles it covered
+         * @param site_id   4-letter WSR-88D id
+         */
+        void remove_site(const std::string& site_id);
+
+        int width() const { return width_; }
+        int height() const { return height_; }
+        int tiles_x() const { return tiles_x_; }
+        int tiles_y() const { return tiles_y_; }
+        const GridSpec& grid() const { return grid_; }
+
+        // Row-major cell values, row 0 at lat_max; rsl::SENTINEL where no site has data
+        const std::vector<float>& values() const { return values_; }
+
+        // Tile indices (ty * tiles_x + tx) rewritten by the last load/update/remove
+        const std::vector<size_t>& dirty_tiles() const { return dirty_tiles_; }
+
+    private:
+        struct SiteVolume;
+        typedef std::shared_ptr<const SiteVolume> SitePtr;
+
+        SitePtr build_site(const SiteSource& source) const;
+        void mark_coverage(const SiteVolume& site, std::vector<bool>& tiles) const;
+        void compose(const std::vector<bool>& tiles);
+        void compose_tile(size_t tile, const std::vector<const SiteVolume*>& sites);
+
+        GridSpec grid_;
+        rsl::PRODUCT_TYPE product_type_;
+        OVERLAP_RULE rule_;
+        int width_ = 0;
+        int height_ = 0;
+        int tiles_x_ = 0;
+        int tiles_y_ = 0;
+        std::vector<float> values_;
+        std::vector<size_t> dirty_tiles_;
+        std::map<std::string, SitePtr> sites_;
+};
+
+};
+
+#endif
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstddef>
+
+#include <glad/glad.h>
+
+#include "gpu_volume.hpp"
+
+namespace render {
+
+void GpuVolume::add_product(rsl::PRODUCT_TYPE moment, const rsl::Product& product){
+    SweepBuffers sweep;
+    for (size_t i = 0; i < product.scans.size(); ++i) {
+        build_sweep_buffers(product.scans[i], sweep);
+        add_sweep(moment, static_cast<int>(i), product.scans[i].elevation, sweep);
+    }
+}
+
+void GpuVolume::add_sweep(rsl::PRODUCT_TYPE moment, int tilt, float elevation, const SweepBuffers& sweep){
+    if (uploaded_) {
+        slots_.clear();
+        uploaded_ = false;
+    }
+
+    SweepSlot slot;
+    slot.moment = moment;
+    slot.tilt = tilt;
+    slot.elevation = elevation;
+    slot.max_range = sweep.max_range;
+    slot.first_gate = staged_gates_.size();
+    slot.gate_count = sweep.gates.size();
+    slot.radial_base = static_cast<int>(staged_meta_.size() / RADIAL_META_STRIDE);
+    slot.radial_count = static_cast<int>(sweep.radial_meta.size() / RADIAL_META_STRIDE);
+    slots_.push_back(slot);
+
+    staged_gates_.insert(staged_gates_.end(), sweep.gates.begin(), sweep.gates.end());
+    staged_meta_.insert(staged_meta_.end(), sweep.radial_meta.begin(), sweep.radial_meta.end());
+
+    // One table covers every radial with the same range_bin1 / gate_size
+    size_t gate_count = 0;
+    for (const GateInstance &g : sweep.gates) {
+        gate_count = std::max(gate_count, static_cast<size_t>(g.gate_idx) + 1);
+    }
+    geometry::BeamGeometryCache &cache = geometry::BeamGeometryCache::shared();
+    geometry::BeamGeometryCache::TablePtr table;
+    float table_bin1 = 0.0f, table_size = 0.0f;
+    for (int r = 0; r < slot.radial_count; ++r) {
+        const float range_bin1 = sweep.radial_meta[r * RADIAL_META_STRIDE + 1];
+        const float gate_size = sweep.radial_meta[r * RADIAL_META_STRIDE + 2];
+        if (!table || range_bin1 != table_bin1 || gate_size != table_size) {
+            table = cache.get(elevation, range_bin1, gate_size, gate_count);
+            table_bin1 = range_bin1;
+            table_size = gate_size;
+        }
+        auto base = table_bases_.find(table.get());
+        if (base == table_bases_.end()) {
+            base = table_bases_.emplace(table.get(), next_table_base_).first;
+            next_table_base_ += static_cast<int32_t>(table->gate_count());
+            staged_tables_.push_back(table);
+        }
+        staged_radial_geom_.push_back(base->second);
+    }
+}
+
+/**
+ * Implementation
+ * Each VAO points attributes 1-3 at its sweep's byte offset in the shared gate
+ * buffer; radial_idx stays sweep-relative and u_radial_base shifts it into the
+ * shared meta texture.
+ */
+void GpuVolume::upload(){
+    constexpr float quad_vertices[] = {
+        -0.5f, -0.5f,
+         0.5f, -0.5f,
+         0.5f,  0.5f,
+        -0.5f, -0.5f,
+         0.5f,  0.5f,
+        -0.5f,  0.5f,
+    };
+
+    quad_vbo_.create(Buffer::Target::Array);
+    quad_vbo_.set_data(quad_vertices, sizeof(quad_vertices), Buffer::Usage::StaticDraw);
+
+    gate_vbo_.create(Buffer::Target::Array);
+    gate_vbo_.set_data(staged_gates_.data(), sizeof(GateInstance) * staged_gates_.size(), Buffer::Usage::StaticDraw);
+
+    meta_tex_.create(TextureBuffer::Format::RGBA32F);
+    meta_tex_.set_data(staged_meta_.data(), sizeof(float) * staged_meta_.size(), Buffer::Usage::StaticDraw);
+
+    radial_geom_tex_.create(TextureBuffer::Format::R32I);
+    radial_geom_tex_.set_data(staged_radial_geom_.data(), sizeof(int32_t) * staged_radial_geom_.size(), Buffer::Usage::StaticDraw);
+
+    // Only the tables this volume's radials point at, in staging order
+    std::vector<float> beam_texels;
+    beam_texels.reserve(static_cast<size_t>(next_table_base_) * geometry::GEOMETRY_STRIDE);
+    for (const geometry::BeamGeometryCache::TablePtr &table : staged_tables_) {
+        beam_texels.insert(beam_texels.end(), table->texels().begin(), table->texels().end());
+    }
+    beam_geom_tex_.create(TextureBuffer::Format::RGBA32F);
+    beam_geom_tex_.set_data(beam_texels.data(), sizeof(float) * beam_texels.size(), Buffer::Usage::StaticDraw);
+
+    vaos_.clear();
+    vaos_.reserve(slots_.size());
+    for (const SweepSlot &slot : slots_) {
+        VertexArray vao(true);
+        vao.bind();
+
+        quad_vbo_.bind();
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0); // quad position
+        glEnableVertexAttribArray(0);
+
+        const size_t base = slot.first_gate * sizeof(GateInstance);
+        gate_vbo_.bind();
+        glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(GateInstance), (void*)(base + offsetof(GateInstance, gate))); // gate val
+        glVertexAttribIPointer(2, 1, GL_INT, sizeof(GateInstance), (void*)(base + offsetof(GateInstance, gate_idx))); // gate index
+        glVertexAttribIPointer(3, 1, GL_INT, sizeof(GateInstance), (void*)(base + offsetof(GateInstance, radial_idx))); // radial index
+        glEnableVertexAttribArray(1);
+        glEnableVertexAttribArray(2);
+        glEnableVertexAttribArray(3);
+        glVertexAttribDivisor(1, 1);
+        glVertexAttribDivisor(2, 1);
+        glVertexAttribDivisor(3, 1);
+
+        vaos_.push_back(std::move(vao));
+    }
+    glBindVertexArray(0);
+
+    staged_gates_ = std::vector<GateInstance>();
+    staged_meta_ = std::vector<float>();
+    staged_radial_geom_ = std::vector<int32_t>();
+    staged_tables_ = std::vector<geometry::BeamGeometryCache::TablePtr>();
+    table_bases_.clear();
+    next_table_base_ = 0;
+    uploaded_ = true;
+}
+
+const SweepSlot* GpuVolume::find(rsl::PRODUCT_TYPE moment, int tilt) const {
+    for (const SweepSlot &slot : slots_) {
+        if (slot.moment == moment && slot.tilt == tilt) return &slot;
+    }
+    return nullptr;
+}
+
+void GpuVolume::draw(const SweepSlot& slot, const Shader& shader) const {
+    if (!uploaded_ || slot.gate_count == 0) return;
+    const size_t index = static_cast<size_t>(&slot - slots_.data());
+    if (index >= vaos_.size()) return;
+
+    shader.set_int("u_radial_base", slot.radial_base);
+    meta_tex_.bind(RADIAL_META_UNIT);
+    beam_geom_tex_.bind(BEAM_GEOMETRY_UNIT);
+    radial_geom_tex_.bind(RADIAL_GEOMETRY_UNIT);
+    vaos_[index].bind();
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(slot.gate_count));
+}
+
+};
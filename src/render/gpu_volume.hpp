@@ -0,0 +1,104 @@
+#ifndef GPU_VOLUME_HPP
+#define GPU_VOLUME_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "gl/buffer.hpp"
+#include "gl/shader.hpp"
+#include "gl/texture_buffer.hpp"
+#include "gl/vertex_array.hpp"
+#include "geometry/beam_geometry.hpp"
+#include "render/sweep_buffers.hpp"
+#include "rsl/rsl_wrapper.hpp"
+
+namespace render{
+
+// Where one sweep lives inside the shared volume buffers
+typedef struct {
+    rsl::PRODUCT_TYPE moment;
+    int tilt;
+    float elevation;
+    float max_range;
+    size_t first_gate;  // instance offset into the gate buffer
+    size_t gate_count;
+    int radial_base;    // texel offset into the radial meta texture
+    int radial_count;
+} SweepSlot;
+
+// Texture units GpuVolume::draw binds its buffer textures to
+const uint32_t RADIAL_META_UNIT = 0;
+const uint32_t BEAM_GEOMETRY_UNIT = 1;
+const uint32_t RADIAL_GEOMETRY_UNIT = 2;
+
+/**
+ * Every sweep of a volume in one gate instance buffer and one radial meta
+ * buffer texture, uploaded once. Each sweep gets a small VAO pointing at its
+ * range of the shared buffer, so any number of views can draw any sweep
+ * without extra uploads. Gate placement comes from the shared beam geometry
+ * tables: one texture with just the tables this volume uses, plus the table
+ * base per radial.
+ */
+class GpuVolume{
+    public:
+        GpuVolume() = default;
+
+        GpuVolume(const GpuVolume&) = delete;
+        GpuVolume& operator=(const GpuVolume&) = delete;
+
+        /**
+         * @fn add_product
+         * Stages every tilt of a product for the next upload()
+         * @param moment    product type, used to look sweeps up later
+         * @param product   product data; tilt i is product.scans[i]
+         */
+        void add_product(rsl::PRODUCT_TYPE moment, const rsl::Product& product);
+
+        // Stages one already flattened sweep
+        void add_sweep(rsl::PRODUCT_TYPE moment, int tilt, float elevation, const SweepBuffers& sweep);
+
+        /**
+         * @fn upload
+         * Uploads everything staged so far in one buffer each, builds the
+         * per-sweep VAOs and frees the CPU staging copies. Staging after an
+         * upload starts a new volume. Needs a current GL context.
+         */
+        void upload();
+
+        // Slot for (moment, tilt), or nullptr if that sweep is not loaded
+        const SweepSlot* find(rsl::PRODUCT_TYPE moment, int tilt) const;
+
+        const std::vector<SweepSlot>& slots() const { return slots_; }
+
+        /**
+         * @fn draw
+         * Draws one sweep with the currently bound program; the caller has
+         * already set the view uniforms
+         * @param slot      sweep to draw, from find()
+         * @param shader    program using shaders/ref.vert (u_radial_base is set here)
+         */
+        void draw(const SweepSlot& slot, const Shader& shader) const;
+
+    private:
+        std::vector<GateInstance> staged_gates_;
+        std::vector<float> staged_meta_;
+        std::vector<int32_t> staged_radial_geom_;
+        std::vector<geometry::BeamGeometryCache::TablePtr> staged_tables_;
+        std::map<const geometry::BeamTable*, int32_t> table_bases_;  // texel offset of each staged table
+        int32_t next_table_base_ = 0;
+        std::vector<SweepSlot> slots_;
+        bool uploaded_ = false;
+
+        Buffer gate_vbo_;
+        Buffer quad_vbo_;
+        TextureBuffer meta_tex_;
+        TextureBuffer beam_geom_tex_;
+        TextureBuffer radial_geom_tex_;
+        std::vector<VertexArray> vaos_;
+};
+
+};
+
+#endif
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cmath>
+
+#include <glad/glad.h>
+
+#include "multi_panel.hpp"
+
+namespace render {
+
+std::vector<Viewport> grid_layout(size_t panel_count, int fb_width, int fb_height, int gap){
+    std::vector<Viewport> viewports;
+    if (panel_count == 0) return viewports;
+
+    const int cols = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(panel_count))));
+    const int rows = static_cast<int>((panel_count + cols - 1) / cols);
+    const int cell_w = std::max(1, (fb_width - gap * (cols - 1)) / cols);
+    const int cell_h = std::max(1, (fb_height - gap * (rows - 1)) / rows);
+
+    for (size_t i = 0; i < panel_count; ++i) {
+        const int col = static_cast<int>(i) % cols;
+        const int row = static_cast<int>(i) / cols;
+        Viewport v;
+        v.x = col * (cell_w + gap);
+        v.y = fb_height - (row + 1) * cell_h - row * gap;
+        v.width = cell_w;
+        v.height = cell_h;
+        viewports.push_back(v);
+    }
+    return viewports;
+}
+
+MultiPanelRenderer::MultiPanelRenderer(const Shader& shader, const GpuVolume& volume)
+    : shader_(shader), volume_(volume)
+{
+}
+
+void MultiPanelRenderer::draw(const std::vector<Panel>& panels, int fb_width, int fb_height) const {
+    glViewport(0, 0, fb_width, fb_height);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    const std::vector<Viewport> viewports = grid_layout(panels.size(), fb_width, fb_height);
+
+    shader_.use();
+    shader_.set_int("u_radial_meta", static_cast<int>(RADIAL_META_UNIT));
+    shader_.set_int("u_beam_geom", static_cast<int>(BEAM_GEOMETRY_UNIT));
+    shader_.set_int("u_radial_geom", static_cast<int>(RADIAL_GEOMETRY_UNIT));
+    glEnable(GL_SCISSOR_TEST);
+    for (size_t i = 0; i < panels.size(); ++i) {
+        const Panel &panel = panels[i];
+        const Viewport &vp = viewports[i];
+        glViewport(vp.x, vp.y, vp.width, vp.height);
+        glScissor(vp.x, vp.y, vp.width, vp.height);
+        glClearColor(0.08f, 0.10f, 0.12f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        const SweepSlot *slot = volume_.find(panel.moment, panel.tilt);
+        if (!slot || slot->gate_count == 0) continue;
+
+        // Same fit as the single view: max range across the wider axis
+        const float aspect = (vp.height > 0) ? (static_cast<float>(vp.width) / static_cast<float>(vp.height)) : 1.0f;
+        float sx = 1.0f;
+        float sy = 1.0f;
+        if (slot->max_range > 0.0f) {
+            if (aspect >= 1.0f) {
+                sx = 1.0f / slot->max_range;
+                sy = aspect / slot->max_range;
+            } else {
+                sx = 1.0f / (slot->max_range * aspect);
+                sy = 1.0f / slot->max_range;
+            }
+        }
+        shader_.set_vec2("u_view_scale", sx * panel.zoom, sy * panel.zoom);
+        shader_.set_vec2("u_view_offset", panel.offset_x, panel.offset_y);
+        shader_.set_int("u_moment", static_cast<int>(panel.moment));
+
+        volume_.draw(*slot, shader_);
+    }
+    glDisable(GL_SCISSOR_TEST);
+    glBindVertexArray(0);
+}
+
+};
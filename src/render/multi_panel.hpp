@@ -0,0 +1,69 @@
+#ifndef MULTI_PANEL_HPP
+#define MULTI_PANEL_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "gl/shader.hpp"
+#include "render/gpu_volume.hpp"
+#include "rsl/rsl_wrapper.hpp"
+
+namespace render{
+
+// What one panel shows and how it is framed
+typedef struct {
+    rsl::PRODUCT_TYPE moment;
+    int tilt;
+    float zoom = 1.0f;      // 1 fits the sweep's max range across the panel
+    float offset_x = 0.0f;  // pan, in panel NDC
+    float offset_y = 0.0f;
+} Panel;
+
+// Pixel rectangle in the framebuffer, origin bottom-left
+typedef struct {
+    int x;
+    int y;
+    int width;
+    int height;
+} Viewport;
+
+/**
+ * @fn grid_layout
+ * Splits the framebuffer into a near-square grid (1, 1x2, 2x2, 2x3, ...) filled
+ * row by row from the top left
+ * @param panel_count   number of panels
+ * @param fb_width      framebuffer width in pixels
+ * @param fb_height     framebuffer height in pixels
+ * @param gap           pixels left between panels
+ * @returns one viewport per panel
+ */
+std::vector<Viewport> grid_layout(size_t panel_count, int fb_width, int fb_height, int gap = 2);
+
+/**
+ * Draws several panels of one GpuVolume into a single frame. Each panel is
+ * clipped with viewport + scissor and only sets uniforms, so extra panels cost
+ * draw calls but no buffers or uploads.
+ */
+class MultiPanelRenderer{
+    public:
+        MultiPanelRenderer() = delete;
+        MultiPanelRenderer(const Shader& shader, const GpuVolume& volume);
+
+        /**
+         * @fn draw
+         * Clears and draws every panel; panels whose sweep is not loaded are
+         * left clear
+         * @param panels    panels in layout order
+         * @param fb_width  framebuffer width in pixels
+         * @param fb_height framebuffer height in pixels
+         */
+        void draw(const std::vector<Panel>& panels, int fb_width, int fb_height) const;
+
+    private:
+        const Shader& shader_;
+        const GpuVolume& volume_;
+};
+
+};
+
+#endif
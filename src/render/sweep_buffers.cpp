@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <numeric>
+
+#include "sweep_buffers.hpp"
+
+namespace render {
+
+void clear_sweep(SweepBuffers& out){
+    out.gates.clear();
+    out.radial_meta.clear();
+    out.max_range = 0.0f;
+}
+
+void add_radial_meta(SweepBuffers& out, float azimuth, float range_bin1, float gate_size, size_t gate_count){
+    out.radial_meta.push_back(azimuth);
+    out.radial_meta.push_back(range_bin1);
+    out.radial_meta.push_back(gate_size);
+    out.radial_meta.push_back(0.0f);
+
+    if (gate_count > 0) {
+        float radial_max = range_bin1 + gate_size * static_cast<float>(gate_count - 1);
+        if (radial_max > out.max_range) out.max_range = radial_max;
+    } else if (range_bin1 > out.max_range) {
+        out.max_range = range_bin1;
+    }
+}
+
+/**
+ * Implementation
+ * Each radial spans from its azimuth to the next one in azimuth order; the
+ * last wraps around to the first.
+ */
+void finish_sweep(SweepBuffers& out){
+    const size_t radial_count = out.radial_meta.size() / RADIAL_META_STRIDE;
+    if (radial_count == 0) return;
+
+    std::vector<size_t> order(radial_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return out.radial_meta[a * RADIAL_META_STRIDE] < out.radial_meta[b * RADIAL_META_STRIDE];
+    });
+
+    std::vector<float> azimuths_deg(radial_count);
+    for (size_t i = 0; i < radial_count; ++i) {
+        azimuths_deg[i] = out.radial_meta[i * RADIAL_META_STRIDE];
+    }
+
+    for (size_t oi = 0; oi < order.size(); ++oi) {
+        const size_t idx = order[oi];
+        const size_t next_idx = order[(oi + 1) % order.size()];
+        float curr = azimuths_deg[idx];
+        float next = azimuths_deg[next_idx];
+        if (oi + 1 == order.size()) {
+            next += 360.0f;
+        }
+        float d = next - curr;
+        if (d < 0.0f) d += 360.0f;
+        float center = curr + 0.5f * d;
+        if (center >= 360.0f) center -= 360.0f;
+        out.radial_meta[idx * RADIAL_META_STRIDE + 0] = center;
+        out.radial_meta[idx * RADIAL_META_STRIDE + 3] = d * 0.01745329252f;
+    }
+}
+
+void build_sweep_buffers(const rsl::Scan& scan, SweepBuffers& out){
+    clear_sweep(out);
+    out.radial_meta.reserve(scan.radials.size() * RADIAL_META_STRIDE);
+
+    int radial_num = 0;
+    for (const rsl::Radial &r : scan.radials) {
+        add_radial_meta(out, r.azimuth, r.range_bin1, r.gate_size, r.gates.size());
+        int gate_idx = 0;
+        for (float f : r.gates) {
+            GateInstance d;
+            d.gate = f;
+            d.gate_idx = gate_idx;
+            d.radial_idx = radial_num;
+            out.gates.push_back(d);
+            gate_idx++;
+        }
+        radial_num++;
+    }
+
+    finish_sweep(out);
+}
+
+};
@@ -0,0 +1,66 @@
+#ifndef SWEEP_BUFFERS_HPP
+#define SWEEP_BUFFERS_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "rsl/rsl_wrapper.hpp"
+
+/**
+ * Namespace for CPU-side render data shared by the loaders and the GL code
+ */
+namespace render{
+
+// One instanced quad per gate, attribute layout of shaders/ref.vert (locations 1-3)
+typedef struct {
+    float gate;
+    int gate_idx;
+    int radial_idx;
+} GateInstance;
+
+const size_t RADIAL_META_STRIDE = 4;
+
+/**
+ * Upload-ready form of one sweep. radial_meta holds RADIAL_META_STRIDE floats per
+ * radial for the u_radial_meta buffer texture:
+ *   center azimuth (deg), range_bin1 (m), gate_size (m), azimuth width (rad)
+ */
+typedef struct {
+    std::vector<GateInstance> gates;
+    std::vector<float> radial_meta;
+    float max_range = 0.0f;
+} SweepBuffers;
+
+/**
+ * @fn clear_sweep
+ * Empties the buffers but keeps their capacity for the next sweep
+ */
+void clear_sweep(SweepBuffers& out);
+
+/**
+ * @fn add_radial_meta
+ * Appends one radial's metadata. Gates of the radial are appended to out.gates
+ * by the caller with radial_idx = number of radials added before this one.
+ * @param azimuth       radial azimuth in degrees as reported by RSL
+ * @param range_bin1    range to the first gate in meters
+ * @param gate_size     gate spacing in meters
+ * @param gate_count    number of gates in the radial
+ */
+void add_radial_meta(SweepBuffers& out, float azimuth, float range_bin1, float gate_size, size_t gate_count);
+
+/**
+ * @fn finish_sweep
+ * Replaces raw azimuths with beam centers and fills in the azimuth widths once
+ * all radials are in
+ */
+void finish_sweep(SweepBuffers& out);
+
+/**
+ * @fn build_sweep_buffers
+ * Flattens a Scan into out (clear, one add_radial_meta per radial, finish)
+ */
+void build_sweep_buffers(const rsl::Scan& scan, SweepBuffers& out);
+
+};
+
+#endif
@@ -2,11 +2,14 @@
 #include <string>
 #include <stdexcept>
 #include <cmath>
+#include <cstdlib>
+#include <mutex>
 
 #include "rsl_wrapper.hpp"
 // C API
 extern "C" {
     #include "rsl.h"
+    #include "wsr88d.h"
 }
 
 namespace rsl {
@@ -17,6 +20,11 @@ struct RadarHandle{
 
 static std::vector<Scan> get_scans_from_vol(const Volume *vol);
 static std::vector<Radial> get_radials_from_sweep(const Sweep *sweep, const Volume *vol);
+static Radar *load_radar(const std::string& file_path, const std::string& radar_site);
+
+// RSL keeps decoder state in file-scope statics (sweep hash lists, VCP data),
+// so only one archive may be decoded or freed at a time.
+static std::mutex rsl_decode_mutex;
 
 /**
  * Implementation
@@ -24,13 +32,14 @@ static std::vector<Radial> get_radials_from_sweep(const Sweep *sweep, const Volu
  */
 void RadarData::RadarDeleter::operator()(RadarHandle *r) const noexcept{
     if(r){
+        std::lock_guard<std::mutex> lock(rsl_decode_mutex);
         RSL_free_radar(r->r);
         delete r;
     }
 }
 
 RadarData::RadarData(const std::string& file_path, const std::string& radar_site)
-    : radar_ptr(new RadarHandle{RSL_wsr88d_to_radar(const_cast<char*>(file_path.c_str()), const_cast<char*>(radar_site.c_str()))})
+    : radar_ptr(new RadarHandle{load_radar(file_path, radar_site)})
 {
     if(!radar_ptr || !radar_ptr->r){
         throw std::runtime_error("Could not load level 2 archive file: " + file_path);
@@ -38,6 +47,11 @@ RadarData::RadarData(const std::string& file_path, const std::string& radar_site
 
 }
 
+static Radar *load_radar(const std::string& file_path, const std::string& radar_site){
+    std::lock_guard<std::mutex> lock(rsl_decode_mutex);
+    return RSL_wsr88d_to_radar(const_cast<char*>(file_path.c_str()), const_cast<char*>(radar_site.c_str()));
+}
+
 /**
  * Implementation
  * Creates Product -> Scans -> Radials
@@ -51,7 +65,7 @@ Product RadarData::get_product(PRODUCT_TYPE product_type) {
             vol = radar_ptr->r->v[DZ_INDEX];
             break;
         case VELOCITY:
-            vol = radar_ptr->r->v[VL_INDEX];
+            vol = radar_ptr->r->v[VR_INDEX];
             break;
         case SPECTRAL_WIDTH:
             vol = radar_ptr->r->v[SW_INDEX];
@@ -121,4 +135,29 @@ static std::vector<Radial> get_radials_from_sweep(const Sweep *sweep, const Volu
     return radials;
 }
 
+/**
+ * Implementation
+ * wsr88d_get_site re-reads the table on every call and hands back a malloc'd
+ * record, so copy out what we need and free it.
+ */
+SiteLocation get_site_location(const std::string& radar_site){
+    std::string site = radar_site;
+    Wsr88d_site_info *info = wsr88d_get_site(site.data());
+    if(!info){
+        throw std::runtime_error("Unknown radar site: " + radar_site);
+    }
+
+    auto to_degrees = [](int d, int m, int s){
+        const double sign = (d < 0 || m < 0 || s < 0) ? -1.0 : 1.0;
+        return sign * (std::abs(d) + std::abs(m) / 60.0 + std::abs(s) / 3600.0);
+    };
+
+    SiteLocation loc;
+    loc.latitude = to_degrees(info->latd, info->latm, info->lats);
+    loc.longitude = to_degrees(info->lond, info->lonm, info->lons);
+    loc.height = static_cast<float>(info->height);
+    free(info);
+    return loc;
+}
+
 };
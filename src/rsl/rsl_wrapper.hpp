@@ -42,6 +42,21 @@ typedef struct {
     std::vector<Scan> scans;
 } Product;
 
+// Site position from wsr88d_locations.dat
+typedef struct {
+    double latitude;  // degrees, north positive
+    double longitude; // degrees, east positive
+    float height;     // meters above sea level
+} SiteLocation;
+
+/**
+ * @fn get_site_location
+ * Looks up a WSR-88D site in the vendored location table
+ * @param radar_site    4-letter site identifier (e.g. KTLX)
+ * @returns SiteLocation of the radar
+ */
+SiteLocation get_site_location(const std::string& radar_site);
+
 // RAII wrapper around Radar*
 class RadarData{
     public:
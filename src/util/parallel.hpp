@@ -0,0 +1,80 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Namespace for small shared helpers
+ */
+namespace util{
+
+/**
+ * @fn worker_count
+ * Number of threads worth starting for a batch of independent jobs
+ * @param jobs  number of jobs in the batch
+ * @returns thread count in [1, jobs]
+ */
+inline size_t worker_count(size_t jobs){
+    size_t hw = std::thread::hardware_concurrency();
+    if(hw == 0) hw = 1;
+    return std::max<size_t>(1, std::min(hw, jobs));
+}
+
+/**
+ * @fn parallel_for
+ * Runs fn(i) for every i in [0, count). Jobs are handed out one at a time so
+ * uneven jobs (e.g. tiles with and without coverage) still balance.
+ * The calling thread takes part and the call returns once all jobs finished.
+ * If fn throws, no further jobs are started and the first exception is
+ * rethrown on the calling thread after every worker has been joined.
+ * @param count number of jobs
+ * @param fn    callable taking a size_t job index
+ */
+template <typename Fn>
+void parallel_for(size_t count, Fn&& fn){
+    const size_t workers = worker_count(count);
+    if(workers <= 1){
+        for(size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto run = [&](){
+        try{
+            for(size_t i = next++; i < count; i = next++){
+                fn(i);
+            }
+        } catch(...){
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if(!error) error = std::current_exception();
+            next = count;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    try{
+        for(size_t t = 1; t < workers; ++t){
+            threads.emplace_back(run);
+        }
+    } catch(...){
+        // Could not start a thread; the ones already running and this thread finish the jobs
+    }
+    run();
+    for(std::thread &t : threads){
+        t.join();
+    }
+    if(error) std::rethrow_exception(error);
+}
+
+};
+
+#endif